@@ -0,0 +1,318 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Benchmark of the OROCOS dot service on synthetic deployments
+ * @Author: OROCOS dot service contributors
+ *
+ * Creates a host component with N peers, each with input and output ports spread over nested sub-services,
+ * connects them with DATA, BUFFER and CIRCULAR_BUFFER connections and times Dot::generate() and Dot::execute().
+ *
+ * Usage: rtt_dot_bench [--components 10,100,1000] [--inputs 8] [--outputs 8] [--depth 2]
+ *                      [--data 1000] [--buffer 500] [--circular 500] [--iterations 50] [--file bench.dot]
+ *                      [--scan-threads 0]
+ * Connection counts are per 1000 components and scaled with the number of components.
+ */
+
+#include "../src/rtt_dot_service.hpp"
+#include <rtt/InputPort.hpp>
+#include <rtt/OutputPort.hpp>
+#include <rtt/TaskContext.hpp>
+#include <rtt/os/main.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/stat.h>
+
+using namespace RTT;
+
+// Count every heap allocation of the process
+static std::atomic<unsigned long> allocations(0);
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if(p == 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+struct Options
+{
+    std::vector<unsigned int> components;
+    unsigned int inputs;
+    unsigned int outputs;
+    unsigned int depth;
+    unsigned int data;
+    unsigned int buffer;
+    unsigned int circular;
+    unsigned int iterations;
+    std::string file;
+    unsigned int scan_threads;
+
+    Options()
+        : inputs(8), outputs(8), depth(2), data(1000), buffer(500), circular(500), iterations(50), file("rtt_dot_bench.dot"), scan_threads(0)
+    {
+        unsigned int defaults[] = { 10, 50, 100, 500, 1000, 2000 };
+        components.assign(defaults, defaults + sizeof(defaults) / sizeof(defaults[0]));
+    }
+};
+
+/// A synthetic peer; the ports are declared first so that the component is destroyed before them
+struct Component
+{
+    std::vector<std::unique_ptr<InputPort<double> > > inputs;
+    std::vector<std::unique_ptr<OutputPort<double> > > outputs;
+    std::unique_ptr<TaskContext> tc;
+};
+
+/// Service at the given nesting level: the component itself, sub0, sub0.sub1, ...
+Service::shared_ptr serviceAt(TaskContext* tc, unsigned int level)
+{
+    Service::shared_ptr sv = tc->provides();
+    for(unsigned int l = 0; l < level; l++)
+    {
+        char name[16];
+        snprintf(name, sizeof(name), "sub%u", l);
+        sv = sv->provides(name);
+    }
+    return sv;
+}
+
+void createComponents(const Options& opt, unsigned int n, TaskContext* host, std::vector<Component>& comps)
+{
+    comps.resize(n);
+    for(unsigned int i = 0; i < n; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "comp%u", i);
+        Component& c = comps[i];
+        c.tc.reset(new TaskContext(name));
+        for(unsigned int j = 0; j < opt.inputs; j++)
+        {
+            snprintf(name, sizeof(name), "in%u", j);
+            c.inputs.push_back(std::unique_ptr<InputPort<double> >(new InputPort<double>(name)));
+            serviceAt(c.tc.get(), j % (opt.depth + 1))->addPort(*c.inputs.back());
+        }
+        for(unsigned int j = 0; j < opt.outputs; j++)
+        {
+            snprintf(name, sizeof(name), "out%u", j);
+            c.outputs.push_back(std::unique_ptr<OutputPort<double> >(new OutputPort<double>(name)));
+            serviceAt(c.tc.get(), j % (opt.depth + 1))->addPort(*c.outputs.back());
+        }
+        // Mix the task states so that the component colors vary
+        if(i % 3 == 0)
+            c.tc->configure();
+        if(i % 3 == 1)
+        {
+            c.tc->configure();
+            c.tc->start();
+        }
+        host->addPeer(c.tc.get());
+    }
+}
+
+void connect(const Options& opt, std::vector<Component>& comps, unsigned int count, const ConnPolicy& policy, unsigned int& seed)
+{
+    if(opt.inputs == 0 || opt.outputs == 0 || comps.size() < 2)
+        return;
+    for(unsigned int k = 0; k < count; k++)
+    {
+        // Deterministic pseudo random wiring, so every run measures the same graph
+        seed = seed * 1103515245u + 12345u;
+        unsigned int from = (seed >> 8) % comps.size();
+        seed = seed * 1103515245u + 12345u;
+        unsigned int to = (seed >> 8) % comps.size();
+        if(to == from)
+            to = (to + 1) % comps.size();
+        OutputPort<double>& out = *comps[from].outputs[k % opt.outputs];
+        InputPort<double>& in = *comps[to].inputs[(k / opt.outputs) % opt.inputs];
+        out.connectTo(&in, policy);
+    }
+}
+
+double percentile(std::vector<double>& samples, double p)
+{
+    if(samples.empty())
+        return 0.0;
+    size_t index = std::min(samples.size() - 1, size_t(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+double elapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+void run(const Options& opt, unsigned int n)
+{
+    TaskContext host("host");
+    std::vector<Component> comps;
+    createComponents(opt, n, &host, comps);
+
+    unsigned int seed = n;
+    unsigned int scale_data = opt.data * n / 1000;
+    unsigned int scale_buffer = opt.buffer * n / 1000;
+    unsigned int scale_circular = opt.circular * n / 1000;
+    connect(opt, comps, scale_data, ConnPolicy::data(), seed);
+    connect(opt, comps, scale_buffer, ConnPolicy::buffer(16), seed);
+    ConnPolicy circular = ConnPolicy::buffer(16);
+    circular.type = ConnPolicy::CIRCULAR_BUFFER;
+    connect(opt, comps, scale_circular, circular, seed);
+
+    boost::shared_ptr<Dot> dot(new Dot(&host));
+    host.provides()->addService(dot);
+    dot->m_dot_file = opt.file;
+    dot->m_scan_threads = opt.scan_threads;
+
+    // Warm up the buffers and indices
+    dot->generate();
+
+    std::vector<double> generate_us, execute_us;
+    unsigned long generate_allocs = 0, execute_allocs = 0;
+    for(unsigned int i = 0; i < opt.iterations; i++)
+    {
+        unsigned long before = allocations.load();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        dot->generate();
+        generate_us.push_back(elapsedUs(start));
+        generate_allocs += allocations.load() - before;
+
+        // Nothing changed, so this only measures the change detection
+        before = allocations.load();
+        start = std::chrono::steady_clock::now();
+        dot->execute();
+        execute_us.push_back(elapsedUs(start));
+        execute_allocs += allocations.load() - before;
+    }
+
+    struct stat st;
+    long size = stat(opt.file.c_str(), &st) == 0 ? long(st.st_size) : -1;
+    unsigned int iterations = std::max(1u, opt.iterations);
+    printf("%6u %7u %9.1f %9.1f %9.1f %9.1f %9lu %9.1f %9lu %10ld\n",
+           n, scale_data + scale_buffer + scale_circular,
+           percentile(generate_us, 0.5), percentile(generate_us, 0.9), percentile(generate_us, 0.99),
+           percentile(generate_us, 1.0), generate_allocs / iterations,
+           percentile(execute_us, 0.5), execute_allocs / iterations, size);
+    fflush(stdout);
+
+    for(size_t i = 0; i < comps.size(); i++)
+    {
+        host.removePeer(comps[i].tc->getName());
+        comps[i].tc->stop();
+        for(size_t j = 0; j < comps[i].outputs.size(); j++)
+            comps[i].outputs[j]->disconnect();
+    }
+    host.provides()->removeService("dot");
+}
+
+std::vector<unsigned int> parseList(const char* arg)
+{
+    std::vector<unsigned int> values;
+    const char* p = arg;
+    while(*p)
+    {
+        char* end;
+        unsigned long v = strtoul(p, &end, 10);
+        if(end == p)
+            break;
+        values.push_back(v);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+}
+
+int ORO_main(int argc, char** argv)
+{
+    Options opt;
+    for(int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        unsigned int value = strtoul(argv[i + 1], 0, 10);
+        if(arg == "--components")
+            opt.components = parseList(argv[i + 1]);
+        else if(arg == "--inputs")
+            opt.inputs = value;
+        else if(arg == "--outputs")
+            opt.outputs = value;
+        else if(arg == "--depth")
+            opt.depth = value;
+        else if(arg == "--data")
+            opt.data = value;
+        else if(arg == "--buffer")
+            opt.buffer = value;
+        else if(arg == "--circular")
+            opt.circular = value;
+        else if(arg == "--iterations")
+            opt.iterations = value;
+        else if(arg == "--file")
+            opt.file = argv[i + 1];
+        else if(arg == "--scan-threads")
+            opt.scan_threads = value;
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    printf("# %u inputs, %u outputs, sub-service depth %u, %u scan threads, %u iterations; latencies in us, allocations per call\n",
+           opt.inputs, opt.outputs, opt.depth, opt.scan_threads, opt.iterations);
+    printf("%6s %7s %9s %9s %9s %9s %9s %9s %9s %10s\n",
+           "comps", "conns", "gen p50", "gen p90", "gen p99", "gen max", "gen allc", "skip p50", "skip allc", "bytes");
+    for(size_t i = 0; i < opt.components.size(); i++)
+    {
+        run(opt, opt.components[i]);
+    }
+    return 0;
+}
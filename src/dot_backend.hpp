@@ -0,0 +1,86 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Interface of the output formats of the OROCOS dot service
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_BACKEND_HPP
+#define DOT_BACKEND_HPP
+
+#include "dot_graph.hpp"
+#include "dot_writer.hpp"
+#include <string>
+
+/// Output settings that travel with a snapshot
+struct DotOptions
+{
+    DotOptions() : color_placeholders(false), collapse_clusters(false), bundle_fanout(0), timing(false), channel_stats(false) {}
+
+    /// Additional arguments to pass to the connection drawings
+    std::string conn_args;
+    /// Fill components with DotEmitter::colorPlaceholder() instead of the color of their state, to lay out a graph once for all states
+    bool color_placeholders;
+    /// Draw every cluster of components as a single node, with the connections between clusters aggregated
+    bool collapse_clusters;
+    /// Minimal number of subscribers of an output drawn as a single hub node, 0 to never bundle them
+    unsigned int bundle_fanout;
+    /// Annotate components with their DotGraph::Timing and fill the measured ones by load instead of by state
+    bool timing;
+    /// Draw the DotGraph::ChannelStats of the channels on their edges
+    bool channel_stats;
+};
+
+/** \brief Output format of a deployment snapshot
+ *
+ *  All formats render the same DotGraph, so adding one does not add a traversal of the deployment.
+ *  Backends only touch the snapshot they are given, so they can run outside of the thread that captured it.
+ */
+class DotBackend {
+  public:
+    virtual ~DotBackend() {}
+
+    /** \brief Format the snapshot
+     *
+     *  @param graph the deployment snapshot
+     *  @param options output settings captured with the snapshot
+     *  @param out buffer to append the output to
+     */
+    virtual void render(const DotGraph& graph, const DotOptions& options, DotWriter& out) = 0;
+
+    /// Name of a RTT::base::TaskCore::TaskState
+    static const char* stateName(int state);
+    /// Name of a RTT::ConnPolicy type
+    static const char* typeName(int type);
+};
+#endif
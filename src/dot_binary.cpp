@@ -0,0 +1,314 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_binary.hpp"
+#include <cstring>
+
+const uint32_t DotBinaryHeader::current_version;
+const uint32_t DotBinaryHeader::npos;
+
+namespace {
+const char magic[8] = { 'R', 'T', 'T', 'D', 'O', 'T', 'G', '\0' };
+}
+
+void DotBinaryEmitter::pad(DotWriter& out, size_t base)
+{
+    static const char zeros[4] = { 0, 0, 0, 0 };
+    size_t rest = (out.size() - base) % 4;
+    if(rest != 0)
+    {
+        out.append(zeros, 4 - rest);
+    }
+}
+
+uint32_t DotBinaryEmitter::appendStrings(DotWriter& out, size_t base, const std::string* const* strings, size_t count)
+{
+    // String offsets are filled in while the strings are appended
+    uint32_t table = out.size() - base;
+    uint32_t zero = 0;
+    for(size_t i = 0; i < count; i++)
+    {
+        out.append(&zero, sizeof(zero));
+    }
+    for(size_t i = 0; i < count; i++)
+    {
+        uint32_t offset = out.size() - base;
+        out.overwrite(base + table + i * sizeof(uint32_t), &offset, sizeof(offset));
+        uint32_t length = strings[i]->size();
+        out.append(&length, sizeof(length));
+        out.append(strings[i]->c_str(), length + 1);
+        pad(out, base);
+    }
+    return table;
+}
+
+bool DotBinaryEmitter::readString(const char* data, size_t size, uint32_t offset, uint32_t count, uint32_t i, std::string& str)
+{
+    const uint32_t* offsets = section<uint32_t>(data, size, offset, count);
+    if(!offsets || i >= count)
+    {
+        return false;
+    }
+    const uint32_t* length = section<uint32_t>(data, size, offsets[i], 1);
+    if(!length || *length > size - offsets[i] - sizeof(uint32_t))
+    {
+        return false;
+    }
+    str.assign(data + offsets[i] + sizeof(uint32_t), *length);
+    return true;
+}
+
+uint32_t DotBinaryEmitter::localString(const DotGraph& graph, unsigned int id)
+{
+    if(id == DotGraph::npos)
+    {
+        return DotBinaryHeader::npos;
+    }
+    if(m_local[id] == DotGraph::npos)
+    {
+        m_local[id] = m_used.size();
+        m_used.push_back(&graph.str(id));
+    }
+    return m_local[id];
+}
+
+void DotBinaryEmitter::render(const DotGraph& graph, const DotOptions&, DotWriter& out)
+{
+    const std::vector<DotGraph::Component>& components = graph.components();
+    const std::vector<DotGraph::Port>& ports = graph.ports();
+    const std::vector<DotGraph::Channel>& channels = graph.channels();
+
+    // The snapshot may follow other data in out, offsets are relative to its start
+    size_t base = out.size();
+    DotBinaryHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = DotBinaryHeader::current_version;
+    header.header_size = sizeof(header);
+    header.timestamp = graph.timestamp;
+    header.structure_hash = graph.structure_hash;
+    header.state_hash = graph.state_hash;
+    out.append(&header, sizeof(header));
+
+    // Only the strings the snapshot refers to are written, numbered in order of use
+    m_local.assign(graph.strings().size(), DotGraph::npos);
+    m_used.clear();
+    localString(graph, DotGraph::empty);
+    for(size_t i = 0; i < components.size(); i++)
+    {
+        localString(graph, components[i].name);
+        localString(graph, components[i].cluster);
+    }
+    for(size_t i = 0; i < ports.size(); i++)
+    {
+        localString(graph, ports[i].name);
+        localString(graph, ports[i].path);
+    }
+    for(size_t i = 0; i < channels.size(); i++)
+    {
+        localString(graph, channels[i].writer_comp);
+        localString(graph, channels[i].reader_comp);
+        localString(graph, channels[i].name_id);
+    }
+    header.num_strings = m_used.size();
+    header.strings_offset = appendStrings(out, base, m_used.empty() ? 0 : &m_used[0], m_used.size());
+
+    header.num_components = components.size();
+    header.components_offset = out.size() - base;
+    for(size_t i = 0; i < components.size(); i++)
+    {
+        DotBinaryComponent rec;
+        rec.name = localString(graph, components[i].name);
+        rec.state = components[i].state;
+        rec.first_port = components[i].first_port;
+        rec.num_ports = components[i].num_ports;
+        rec.cluster = localString(graph, components[i].cluster);
+        out.append(&rec, sizeof(rec));
+    }
+
+    header.num_ports = ports.size();
+    header.ports_offset = out.size() - base;
+    for(size_t i = 0; i < ports.size(); i++)
+    {
+        DotBinaryPort rec;
+        rec.name = localString(graph, ports[i].name);
+        rec.path = localString(graph, ports[i].path);
+        rec.component = ports[i].component;
+        rec.field = ports[i].field;
+        rec.direction = ports[i].direction;
+        out.append(&rec, sizeof(rec));
+    }
+
+    header.num_channels = channels.size();
+    header.channels_offset = out.size() - base;
+    for(size_t i = 0; i < channels.size(); i++)
+    {
+        const DotGraph::Channel& ch = channels[i];
+        DotBinaryChannel rec;
+        rec.writer = ch.writer;
+        rec.reader = ch.reader;
+        rec.writer_comp = localString(graph, ch.writer_comp);
+        rec.reader_comp = localString(graph, ch.reader_comp);
+        rec.name_id = localString(graph, ch.name_id);
+        rec.type = ch.type;
+        rec.size = ch.size;
+        rec.lock_policy = ch.lock_policy;
+        rec.transport = ch.transport;
+        rec.init = ch.init;
+        rec.pull = ch.pull;
+        rec.at_input_port = ch.at_input_port;
+        rec.reserved = 0;
+        out.append(&rec, sizeof(rec));
+    }
+
+    header.total_size = out.size() - base;
+    out.overwrite(base, &header, sizeof(header));
+}
+
+bool DotBinaryEmitter::read(const char* data, size_t size, DotGraph& graph)
+{
+    DotBinaryHeader header;
+    if(size < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if(memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != DotBinaryHeader::current_version
+       || header.header_size != sizeof(header) || header.total_size > size)
+    {
+        return false;
+    }
+    size = header.total_size;
+
+    const uint32_t* offsets = section<uint32_t>(data, size, header.strings_offset, header.num_strings);
+    const DotBinaryComponent* components = section<DotBinaryComponent>(data, size, header.components_offset, header.num_components);
+    const DotBinaryPort* ports = section<DotBinaryPort>(data, size, header.ports_offset, header.num_ports);
+    const DotBinaryChannel* channels = section<DotBinaryChannel>(data, size, header.channels_offset, header.num_channels);
+    if(!offsets || !components || !ports || !channels)
+    {
+        return false;
+    }
+
+    // Map the string ids of the snapshot to the ids in graph
+    std::vector<unsigned int> ids(header.num_strings);
+    std::string str;
+    for(uint32_t i = 0; i < header.num_strings; i++)
+    {
+        if(!readString(data, size, header.strings_offset, header.num_strings, i, str))
+        {
+            return false;
+        }
+        ids[i] = graph.intern(str);
+    }
+    struct Id
+    {
+        const std::vector<unsigned int>& ids;
+        bool ok;
+        unsigned int operator()(uint32_t id)
+        {
+            if(id == DotBinaryHeader::npos)
+                return DotGraph::npos;
+            if(id >= ids.size())
+            {
+                ok = false;
+                return DotGraph::empty;
+            }
+            return ids[id];
+        }
+    } id = { ids, true };
+
+    graph.clear();
+    graph.timestamp = header.timestamp;
+    graph.structure_hash = header.structure_hash;
+    graph.state_hash = header.state_hash;
+    for(uint32_t i = 0; i < header.num_components; i++)
+    {
+        const DotBinaryComponent& comp = components[i];
+        if(comp.first_port != graph.ports().size() || comp.num_ports > header.num_ports - comp.first_port)
+        {
+            return false;
+        }
+        graph.addComponent(id(comp.name), comp.state, id(comp.cluster));
+        for(uint32_t j = comp.first_port; j < comp.first_port + comp.num_ports; j++)
+        {
+            const DotBinaryPort& port = ports[j];
+            graph.addPort(id(port.path), id(port.name), port.direction == DotGraph::Input ? DotGraph::Input : DotGraph::Output, port.field);
+        }
+    }
+    if(graph.ports().size() != header.num_ports)
+    {
+        return false;
+    }
+    for(uint32_t i = 0; i < header.num_channels; i++)
+    {
+        const DotBinaryChannel& rec = channels[i];
+        if((rec.writer != DotBinaryHeader::npos && rec.writer >= header.num_ports)
+           || (rec.reader != DotBinaryHeader::npos && rec.reader >= header.num_ports))
+        {
+            return false;
+        }
+        DotGraph::Channel ch;
+        ch.writer = rec.writer == DotBinaryHeader::npos ? DotGraph::npos : rec.writer;
+        ch.reader = rec.reader == DotBinaryHeader::npos ? DotGraph::npos : rec.reader;
+        ch.writer_comp = id(rec.writer_comp);
+        ch.reader_comp = id(rec.reader_comp);
+        ch.name_id = id(rec.name_id);
+        ch.type = rec.type;
+        ch.size = rec.size;
+        ch.lock_policy = rec.lock_policy;
+        ch.transport = rec.transport;
+        ch.init = rec.init != 0;
+        ch.pull = rec.pull != 0;
+        ch.at_input_port = rec.at_input_port != 0;
+        graph.addChannel(ch);
+    }
+    return id.ok;
+}
+
+size_t DotBinaryEmitter::beginFrame(DotWriter& out, uint32_t type, uint64_t timestamp)
+{
+    size_t pos = out.size();
+    DotBinaryFrame frame;
+    frame.size = 0;
+    frame.type = type;
+    frame.timestamp = timestamp;
+    out.append(&frame, sizeof(frame));
+    return pos;
+}
+
+void DotBinaryEmitter::endFrame(DotWriter& out, size_t pos)
+{
+    uint32_t size = out.size() - pos - sizeof(DotBinaryFrame);
+    out.overwrite(pos, &size, sizeof(size));
+}
@@ -0,0 +1,179 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Compact binary output of a deployment snapshot
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_BINARY_HPP
+#define DOT_BINARY_HPP
+
+#include "dot_backend.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** @name Binary snapshot layout
+ *
+ *  A binary snapshot starts with a DotBinaryHeader, followed by the string table and by arrays of fixed size records.
+ *  All offsets are in bytes from the start of the header, every section is 4 byte aligned and all values are in native byte order, so a reader can map the file and use the records in place.
+ *  The string table is an array of num_strings offsets, each pointing to a uint32_t length followed by the characters and a terminating zero.
+ *  Records refer to strings, components and ports by their index, like DotGraph does; DotBinaryHeader::npos marks a missing reference.
+ *  The string table only holds the strings the records refer to, the first one being the empty string.
+ */
+//@{
+struct DotBinaryHeader
+{
+    static const uint32_t current_version = 2;
+    static const uint32_t npos = ~0u;
+
+    /// "RTTDOTG" and a terminating zero
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t timestamp;
+    uint64_t structure_hash;
+    uint64_t state_hash;
+    /// Size of the snapshot including this header
+    uint32_t total_size;
+    uint32_t num_strings;
+    uint32_t strings_offset;
+    uint32_t num_components;
+    uint32_t components_offset;
+    uint32_t num_ports;
+    uint32_t ports_offset;
+    uint32_t num_channels;
+    uint32_t channels_offset;
+    uint32_t reserved;
+};
+
+struct DotBinaryComponent
+{
+    uint32_t name;
+    int32_t state;
+    uint32_t first_port;
+    uint32_t num_ports;
+    /// Since version 2
+    uint32_t cluster;
+};
+
+struct DotBinaryPort
+{
+    uint32_t name;
+    uint32_t path;
+    uint32_t component;
+    uint32_t field;
+    /// DotGraph::Direction
+    uint32_t direction;
+};
+
+struct DotBinaryChannel
+{
+    uint32_t writer;
+    uint32_t reader;
+    uint32_t writer_comp;
+    uint32_t reader_comp;
+    uint32_t name_id;
+    /// RTT::ConnPolicy fields
+    int32_t type;
+    int32_t size;
+    int32_t lock_policy;
+    int32_t transport;
+    uint8_t init;
+    uint8_t pull;
+    uint8_t at_input_port;
+    uint8_t reserved;
+};
+
+/** \brief Header of a frame in a stream or recording of snapshots
+ *
+ *  Followed by size bytes of payload: a binary snapshot for SnapshotFrame, a binary delta (see dot_delta.hpp) for DeltaFrame.
+ */
+struct DotBinaryFrame
+{
+    enum Type { SnapshotFrame = 1, DeltaFrame = 2 };
+
+    uint32_t size;
+    uint32_t type;
+    uint64_t timestamp;
+};
+//@}
+
+/// Writes a DotGraph in the binary snapshot layout
+class DotBinaryEmitter : public DotBackend {
+  public:
+    void render(const DotGraph& graph, const DotOptions& options, DotWriter& out);
+
+    /** \brief Read a binary snapshot back into a graph
+     *
+     *  @param data the snapshot, starting with its header
+     *  @param size number of bytes available at data
+     *  @param graph cleared and filled with the snapshot; strings it already holds keep their ids
+     *  @return false if data does not hold a valid snapshot
+     */
+    static bool read(const char* data, size_t size, DotGraph& graph);
+
+    /// Pad out with zeros to a multiple of 4 bytes from base
+    static void pad(DotWriter& out, size_t base);
+    /** Append a string table of count strings, as described for the binary snapshot layout
+     *  @return offset of the table relative to base
+     */
+    static uint32_t appendStrings(DotWriter& out, size_t base, const std::string* const* strings, size_t count);
+    /// Array of count records of type T at offset, 0 if it does not fit in size bytes
+    template<class T>
+    static const T* section(const char* data, size_t size, uint32_t offset, uint32_t count)
+    {
+        if(offset > size || count > (size - offset) / sizeof(T) || offset % 4 != 0)
+        {
+            return 0;
+        }
+        return reinterpret_cast<const T*>(data + offset);
+    }
+    /// Read string i of the string table at offset, false if it does not fit in size bytes
+    static bool readString(const char* data, size_t size, uint32_t offset, uint32_t count, uint32_t i, std::string& str);
+
+    /// Append a frame of the given type; the payload has to be appended next and closed with endFrame()
+    static size_t beginFrame(DotWriter& out, uint32_t type, uint64_t timestamp);
+    /// Set the payload size of the frame started at pos
+    static void endFrame(DotWriter& out, size_t pos);
+
+  private:
+    /// Index in the string table of the snapshot of string id, adding it to m_used if needed
+    uint32_t localString(const DotGraph& graph, unsigned int id);
+
+    // String table of the snapshot being rendered, reused across calls
+    std::vector<unsigned int> m_local;
+    std::vector<const std::string*> m_used;
+};
+#endif
@@ -0,0 +1,604 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_delta.hpp"
+#include "dot_binary.hpp"
+#include <cstring>
+
+const uint32_t DotBinaryDeltaHeader::current_version;
+
+namespace {
+const char magic[8] = { 'R', 'T', 'T', 'D', 'O', 'T', 'D', '\0' };
+}
+
+DotDelta::DotDelta()
+    : timestamp(0), base_structure_hash(0), base_state_hash(0), structure_hash(0), state_hash(0)
+{
+}
+
+size_t DotDelta::ChannelKeyHash::operator()(const ChannelKey& k) const
+{
+    size_t h = k.at_input_port;
+    const unsigned int ids[6] = { k.writer_comp, k.writer_path, k.writer_name, k.reader_comp, k.reader_path, k.reader_name };
+    for(unsigned int i = 0; i < 6; i++)
+    {
+        h = h * 1000003 + ids[i];
+    }
+    return h;
+}
+
+DotDelta::ChannelKey DotDelta::channelKey(const DotGraph& graph, const DotGraph::Channel& ch)
+{
+    // Ports are compared by name, as their indices differ between snapshots
+    ChannelKey key;
+    key.writer_comp = ch.writer_comp;
+    key.writer_path = key.writer_name = DotGraph::npos;
+    if(ch.writer != DotGraph::npos)
+    {
+        const DotGraph::Port& port = graph.ports()[ch.writer];
+        key.writer_comp = graph.components()[port.component].name;
+        key.writer_path = port.path;
+        key.writer_name = port.name;
+    }
+    key.reader_comp = ch.reader_comp;
+    key.reader_path = key.reader_name = DotGraph::npos;
+    if(ch.reader != DotGraph::npos)
+    {
+        const DotGraph::Port& port = graph.ports()[ch.reader];
+        key.reader_comp = graph.components()[port.component].name;
+        key.reader_path = port.path;
+        key.reader_name = port.name;
+    }
+    key.at_input_port = ch.at_input_port;
+    return key;
+}
+
+bool DotDelta::samePolicy(const DotGraph::Channel& a, const DotGraph::Channel& b)
+{
+    return a.type == b.type && a.size == b.size && a.lock_policy == b.lock_policy && a.transport == b.transport
+        && a.init == b.init && a.pull == b.pull && a.name_id == b.name_id;
+}
+
+void DotDelta::add(Op op, uint32_t index, uint32_t component, uint32_t name, uint32_t path, int32_t value)
+{
+    Record rec;
+    rec.op = op;
+    rec.index = index;
+    rec.component = component;
+    rec.name = name;
+    rec.path = path;
+    rec.value = value;
+    m_records.push_back(rec);
+}
+
+void DotDelta::compute(const DotGraph& base, const DotGraph& current)
+{
+    const std::vector<DotGraph::Component>& base_comps = base.components();
+    const std::vector<DotGraph::Component>& comps = current.components();
+    const std::vector<DotGraph::Port>& base_ports = base.ports();
+    const std::vector<DotGraph::Port>& ports = current.ports();
+    const std::vector<DotGraph::Channel>& base_channels = base.channels();
+    const std::vector<DotGraph::Channel>& channels = current.channels();
+
+    m_records.clear();
+    m_channels.clear();
+    timestamp = current.timestamp;
+    base_structure_hash = base.structure_hash;
+    base_state_hash = base.state_hash;
+    structure_hash = current.structure_hash;
+    state_hash = current.state_hash;
+
+    // An element is kept if it is in both snapshots and in the same order relative to the other kept ones,
+    // everything else is removed from the base and inserted at its final position
+    m_base_component.assign(comps.size(), DotGraph::npos);
+    m_kept_component.assign(base_comps.size(), DotGraph::npos);
+    unsigned int last = DotGraph::npos;
+    for(unsigned int i = 0; i < comps.size(); i++)
+    {
+        unsigned int b = base.findComponent(comps[i].name);
+        if(b != DotGraph::npos && (last == DotGraph::npos || b > last))
+        {
+            m_base_component[i] = b;
+            m_kept_component[b] = i;
+            last = b;
+        }
+    }
+
+    m_base_port.assign(base_ports.size(), DotGraph::npos);
+    m_kept_port.assign(ports.size(), false);
+    for(unsigned int i = 0; i < comps.size(); i++)
+    {
+        unsigned int b = m_base_component[i];
+        if(b == DotGraph::npos)
+        {
+            continue;
+        }
+        last = DotGraph::npos;
+        for(unsigned int j = comps[i].first_port; j < comps[i].first_port + comps[i].num_ports; j++)
+        {
+            unsigned int q = base.findPort(b, ports[j].path, ports[j].name);
+            if(q != DotGraph::npos && base_ports[q].direction == ports[j].direction && (last == DotGraph::npos || q > last))
+            {
+                m_base_port[q] = j;
+                m_kept_port[j] = true;
+                last = q;
+            }
+        }
+    }
+
+    for(unsigned int b = base_comps.size(); b-- > 0;)
+    {
+        if(m_kept_component[b] == DotGraph::npos)
+        {
+            add(RemoveComponent, b);
+        }
+    }
+    for(unsigned int i = 0; i < comps.size(); i++)
+    {
+        if(m_base_component[i] == DotGraph::npos)
+        {
+            add(AddComponent, i, 0, comps[i].name, comps[i].cluster, comps[i].state);
+            continue;
+        }
+        if(base_comps[m_base_component[i]].state != comps[i].state)
+        {
+            add(SetState, i, 0, 0, 0, comps[i].state);
+        }
+        if(base_comps[m_base_component[i]].cluster != comps[i].cluster)
+        {
+            add(SetCluster, i, 0, 0, comps[i].cluster);
+        }
+    }
+    for(unsigned int i = 0; i < comps.size(); i++)
+    {
+        unsigned int b = m_base_component[i];
+        if(b != DotGraph::npos)
+        {
+            for(unsigned int q = base_comps[b].first_port + base_comps[b].num_ports; q-- > base_comps[b].first_port;)
+            {
+                if(m_base_port[q] == DotGraph::npos)
+                {
+                    add(RemovePort, q - base_comps[b].first_port, i);
+                }
+            }
+        }
+        for(unsigned int j = comps[i].first_port; j < comps[i].first_port + comps[i].num_ports; j++)
+        {
+            if(!m_kept_port[j])
+            {
+                add(AddPort, j - comps[i].first_port, i, ports[j].name, ports[j].path, ports[j].direction);
+            }
+        }
+    }
+
+    // Endpoints outside of the graph are only known by their owner, so several channels can share a key:
+    // the index holds the first of them, m_same_key chains the others in order
+    m_channel_index.clear();
+    m_same_key.assign(base_channels.size(), DotGraph::npos);
+    for(unsigned int b = base_channels.size(); b-- > 0;)
+    {
+        ChannelKey key = channelKey(base, base_channels[b]);
+        m_same_key[b] = m_channel_index.find(key);
+        m_channel_index.insert(key, b);
+    }
+    m_base_channel.assign(base_channels.size(), DotGraph::npos);
+    m_kept_channel.assign(channels.size(), false);
+    last = DotGraph::npos;
+    for(unsigned int k = 0; k < channels.size(); k++)
+    {
+        unsigned int b = m_channel_index.find(channelKey(current, channels[k]));
+        while(b != DotGraph::npos && last != DotGraph::npos && b <= last)
+        {
+            b = m_same_key[b];
+        }
+        if(b == DotGraph::npos)
+        {
+            continue;
+        }
+        // A kept channel has to keep its endpoint ports too
+        const DotGraph::Channel& ch = base_channels[b];
+        if((ch.writer != DotGraph::npos && m_base_port[ch.writer] == DotGraph::npos)
+           || (ch.reader != DotGraph::npos && m_base_port[ch.reader] == DotGraph::npos))
+        {
+            continue;
+        }
+        m_base_channel[b] = k;
+        m_kept_channel[k] = true;
+        last = b;
+    }
+
+    for(unsigned int b = base_channels.size(); b-- > 0;)
+    {
+        if(m_base_channel[b] == DotGraph::npos)
+        {
+            add(RemoveChannel, b);
+        }
+    }
+    for(unsigned int k = 0; k < channels.size(); k++)
+    {
+        if(!m_kept_channel[k])
+        {
+            add(AddChannel, k, 0, 0, 0, m_channels.size());
+            m_channels.push_back(channels[k]);
+        }
+    }
+    for(unsigned int b = 0; b < base_channels.size(); b++)
+    {
+        unsigned int k = m_base_channel[b];
+        if(k != DotGraph::npos && !samePolicy(base_channels[b], channels[k]))
+        {
+            add(SetPolicy, k, 0, 0, 0, m_channels.size());
+            m_channels.push_back(channels[k]);
+        }
+    }
+}
+
+bool DotDelta::apply(DotGraph& graph) const
+{
+    if(graph.structure_hash != base_structure_hash || graph.state_hash != base_state_hash)
+    {
+        return false;
+    }
+
+    // Edit a copy in which ports are identified by a number that survives the edits: their base index, or a new one for added ports
+    struct EditPort
+    {
+        unsigned int id, path, name;
+        DotGraph::Direction direction;
+    };
+    struct EditComponent
+    {
+        unsigned int name;
+        int state;
+        unsigned int cluster;
+        std::vector<EditPort> ports;
+    };
+    std::vector<EditComponent> comps(graph.components().size());
+    for(unsigned int i = 0; i < comps.size(); i++)
+    {
+        const DotGraph::Component& comp = graph.components()[i];
+        comps[i].name = comp.name;
+        comps[i].state = comp.state;
+        comps[i].cluster = comp.cluster;
+        for(unsigned int j = comp.first_port; j < comp.first_port + comp.num_ports; j++)
+        {
+            const DotGraph::Port& port = graph.ports()[j];
+            EditPort p = { j, port.path, port.name, port.direction };
+            comps[i].ports.push_back(p);
+        }
+    }
+    std::vector<DotGraph::Channel> channels(graph.channels());
+    // Channels added by the delta refer to final port indices, the others to port ids
+    std::vector<bool> final_ports(channels.size(), false);
+    unsigned int next_id = graph.ports().size();
+    unsigned int num_strings = graph.strings().size();
+
+    for(unsigned int r = 0; r < m_records.size(); r++)
+    {
+        const Record& rec = m_records[r];
+        bool component_op = rec.op == SetState || rec.op == SetCluster || rec.op == RemovePort || rec.op == AddPort;
+        unsigned int c = rec.op == SetState || rec.op == SetCluster ? rec.index : rec.component;
+        if(component_op && c >= comps.size())
+        {
+            return false;
+        }
+        bool channel_ref = rec.op == AddChannel || rec.op == SetPolicy;
+        if(channel_ref && (rec.value < 0 || unsigned(rec.value) >= m_channels.size()))
+        {
+            return false;
+        }
+        switch(rec.op)
+        {
+            case RemoveComponent:
+                if(rec.index >= comps.size())
+                    return false;
+                comps.erase(comps.begin() + rec.index);
+                break;
+            case AddComponent:
+            {
+                if(rec.index > comps.size() || rec.name >= num_strings || rec.path >= num_strings)
+                    return false;
+                EditComponent comp;
+                comp.name = rec.name;
+                comp.state = rec.value;
+                comp.cluster = rec.path;
+                comps.insert(comps.begin() + rec.index, comp);
+                break;
+            }
+            case SetState:
+                comps[c].state = rec.value;
+                break;
+            case SetCluster:
+                if(rec.path >= num_strings)
+                    return false;
+                comps[c].cluster = rec.path;
+                break;
+            case RemovePort:
+                if(rec.index >= comps[c].ports.size())
+                    return false;
+                comps[c].ports.erase(comps[c].ports.begin() + rec.index);
+                break;
+            case AddPort:
+            {
+                if(rec.index > comps[c].ports.size() || rec.name >= num_strings || rec.path >= num_strings)
+                    return false;
+                EditPort p = { next_id++, rec.path, rec.name, rec.value == DotGraph::Input ? DotGraph::Input : DotGraph::Output };
+                comps[c].ports.insert(comps[c].ports.begin() + rec.index, p);
+                break;
+            }
+            case RemoveChannel:
+                if(rec.index >= channels.size())
+                    return false;
+                channels.erase(channels.begin() + rec.index);
+                final_ports.erase(final_ports.begin() + rec.index);
+                break;
+            case AddChannel:
+                if(rec.index > channels.size())
+                    return false;
+                channels.insert(channels.begin() + rec.index, m_channels[rec.value]);
+                final_ports.insert(final_ports.begin() + rec.index, true);
+                break;
+            case SetPolicy:
+            {
+                if(rec.index >= channels.size())
+                    return false;
+                const DotGraph::Channel& policy = m_channels[rec.value];
+                DotGraph::Channel& ch = channels[rec.index];
+                ch.type = policy.type;
+                ch.size = policy.size;
+                ch.lock_policy = policy.lock_policy;
+                ch.transport = policy.transport;
+                ch.init = policy.init;
+                ch.pull = policy.pull;
+                ch.name_id = policy.name_id;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Final index of every port id, npos for removed ports
+    std::vector<unsigned int> index(next_id, DotGraph::npos);
+    unsigned int num_ports = 0;
+    for(unsigned int i = 0; i < comps.size(); i++)
+    {
+        for(unsigned int j = 0; j < comps[i].ports.size(); j++)
+        {
+            index[comps[i].ports[j].id] = num_ports++;
+        }
+    }
+    for(unsigned int k = 0; k < channels.size(); k++)
+    {
+        DotGraph::Channel& ch = channels[k];
+        if(!final_ports[k])
+        {
+            ch.writer = ch.writer == DotGraph::npos ? DotGraph::npos : index[ch.writer];
+            ch.reader = ch.reader == DotGraph::npos ? DotGraph::npos : index[ch.reader];
+        }
+        else if((ch.writer != DotGraph::npos && ch.writer >= num_ports) || (ch.reader != DotGraph::npos && ch.reader >= num_ports))
+        {
+            return false;
+        }
+    }
+
+    graph.clear();
+    graph.timestamp = timestamp;
+    graph.structure_hash = structure_hash;
+    graph.state_hash = state_hash;
+    for(unsigned int i = 0; i < comps.size(); i++)
+    {
+        graph.addComponent(comps[i].name, comps[i].state, comps[i].cluster);
+        // Record fields number the ports of each direction in order, like Dot::scan() does
+        unsigned int inputs = 0, outputs = 0;
+        for(unsigned int j = 0; j < comps[i].ports.size(); j++)
+        {
+            const EditPort& p = comps[i].ports[j];
+            graph.addPort(p.path, p.name, p.direction, p.direction == DotGraph::Input ? inputs++ : outputs++);
+        }
+    }
+    for(unsigned int k = 0; k < channels.size(); k++)
+    {
+        graph.addChannel(channels[k]);
+    }
+    return true;
+}
+
+void DotDelta::render(const DotGraph& graph, DotWriter& out)
+{
+    // Only the strings the delta refers to are written, numbered in order of use
+    m_local.assign(graph.strings().size(), DotGraph::npos);
+    m_used.clear();
+    struct Local
+    {
+        const DotGraph& graph;
+        std::vector<unsigned int>& local;
+        std::vector<const std::string*>& used;
+        uint32_t operator()(unsigned int id)
+        {
+            if(id == DotGraph::npos)
+                return DotBinaryHeader::npos;
+            if(local[id] == DotGraph::npos)
+            {
+                local[id] = used.size();
+                used.push_back(&graph.str(id));
+            }
+            return local[id];
+        }
+    } local = { graph, m_local, m_used };
+
+    size_t base = out.size();
+    DotBinaryDeltaHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = DotBinaryDeltaHeader::current_version;
+    header.header_size = sizeof(header);
+    header.timestamp = timestamp;
+    header.base_structure_hash = base_structure_hash;
+    header.base_state_hash = base_state_hash;
+    header.structure_hash = structure_hash;
+    header.state_hash = state_hash;
+    out.append(&header, sizeof(header));
+
+    header.num_records = m_records.size();
+    header.records_offset = out.size() - base;
+    for(size_t i = 0; i < m_records.size(); i++)
+    {
+        Record rec = m_records[i];
+        if(rec.op == AddComponent || rec.op == AddPort)
+        {
+            rec.name = local(rec.name);
+        }
+        if(rec.op == AddComponent || rec.op == AddPort || rec.op == SetCluster)
+        {
+            rec.path = local(rec.path);
+        }
+        out.append(&rec, sizeof(rec));
+    }
+
+    header.num_channels = m_channels.size();
+    header.channels_offset = out.size() - base;
+    for(size_t i = 0; i < m_channels.size(); i++)
+    {
+        const DotGraph::Channel& ch = m_channels[i];
+        DotBinaryChannel rec;
+        rec.writer = ch.writer;
+        rec.reader = ch.reader;
+        rec.writer_comp = local(ch.writer_comp);
+        rec.reader_comp = local(ch.reader_comp);
+        rec.name_id = local(ch.name_id);
+        rec.type = ch.type;
+        rec.size = ch.size;
+        rec.lock_policy = ch.lock_policy;
+        rec.transport = ch.transport;
+        rec.init = ch.init;
+        rec.pull = ch.pull;
+        rec.at_input_port = ch.at_input_port;
+        rec.reserved = 0;
+        out.append(&rec, sizeof(rec));
+    }
+
+    header.num_strings = m_used.size();
+    header.strings_offset = DotBinaryEmitter::appendStrings(out, base, m_used.empty() ? 0 : &m_used[0], m_used.size());
+    header.total_size = out.size() - base;
+    out.overwrite(base, &header, sizeof(header));
+}
+
+bool DotDelta::read(const char* data, size_t size, DotGraph& graph)
+{
+    DotBinaryDeltaHeader header;
+    if(size < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if(memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != DotBinaryDeltaHeader::current_version
+       || header.header_size != sizeof(header) || header.total_size > size)
+    {
+        return false;
+    }
+    size = header.total_size;
+
+    const Record* records = DotBinaryEmitter::section<Record>(data, size, header.records_offset, header.num_records);
+    const DotBinaryChannel* channels = DotBinaryEmitter::section<DotBinaryChannel>(data, size, header.channels_offset, header.num_channels);
+    if(!records || !channels)
+    {
+        return false;
+    }
+
+    m_local.resize(header.num_strings);
+    std::string str;
+    for(uint32_t i = 0; i < header.num_strings; i++)
+    {
+        if(!DotBinaryEmitter::readString(data, size, header.strings_offset, header.num_strings, i, str))
+        {
+            return false;
+        }
+        m_local[i] = graph.intern(str);
+    }
+    struct Id
+    {
+        const std::vector<unsigned int>& ids;
+        bool ok;
+        unsigned int operator()(uint32_t id)
+        {
+            if(id == DotBinaryHeader::npos)
+                return DotGraph::npos;
+            if(id >= ids.size())
+            {
+                ok = false;
+                return DotGraph::empty;
+            }
+            return ids[id];
+        }
+    } id = { m_local, true };
+
+    timestamp = header.timestamp;
+    base_structure_hash = header.base_structure_hash;
+    base_state_hash = header.base_state_hash;
+    structure_hash = header.structure_hash;
+    state_hash = header.state_hash;
+    m_records.assign(records, records + header.num_records);
+    for(size_t i = 0; i < m_records.size(); i++)
+    {
+        Record& rec = m_records[i];
+        if(rec.op == AddComponent || rec.op == AddPort)
+        {
+            rec.name = id(rec.name);
+        }
+        if(rec.op == AddComponent || rec.op == AddPort || rec.op == SetCluster)
+        {
+            rec.path = id(rec.path);
+        }
+    }
+    m_channels.resize(header.num_channels);
+    for(uint32_t i = 0; i < header.num_channels; i++)
+    {
+        const DotBinaryChannel& rec = channels[i];
+        DotGraph::Channel& ch = m_channels[i];
+        ch.writer = rec.writer == DotBinaryHeader::npos ? DotGraph::npos : rec.writer;
+        ch.reader = rec.reader == DotBinaryHeader::npos ? DotGraph::npos : rec.reader;
+        ch.writer_comp = id(rec.writer_comp);
+        ch.reader_comp = id(rec.reader_comp);
+        ch.name_id = id(rec.name_id);
+        ch.type = rec.type;
+        ch.size = rec.size;
+        ch.lock_policy = rec.lock_policy;
+        ch.transport = rec.transport;
+        ch.init = rec.init != 0;
+        ch.pull = rec.pull != 0;
+        ch.at_input_port = rec.at_input_port != 0;
+    }
+    return id.ok;
+}
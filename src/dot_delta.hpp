@@ -0,0 +1,189 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Changes between two deployment snapshots
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_DELTA_HPP
+#define DOT_DELTA_HPP
+
+#include "dot_flat_map.hpp"
+#include "dot_graph.hpp"
+#include "dot_writer.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/** \brief Header of a binary delta
+ *
+ *  Followed by the records, the channels they refer to and a string table, laid out like the sections of a binary snapshot (see dot_binary.hpp).
+ *  Records and channels refer to strings by their index in the string table of the delta.
+ */
+struct DotBinaryDeltaHeader
+{
+    static const uint32_t current_version = 2;
+
+    /// "RTTDOTD" and a terminating zero
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t timestamp;
+    /// Fingerprints of the snapshot the delta applies to
+    uint64_t base_structure_hash;
+    uint64_t base_state_hash;
+    /// Fingerprints of the snapshot the delta results in
+    uint64_t structure_hash;
+    uint64_t state_hash;
+    /// Size of the delta including this header
+    uint32_t total_size;
+    uint32_t num_strings;
+    uint32_t strings_offset;
+    uint32_t num_records;
+    uint32_t records_offset;
+    uint32_t num_channels;
+    uint32_t channels_offset;
+    uint32_t reserved;
+};
+
+/** \brief Changes turning one deployment snapshot into the next one
+ *
+ *  Components are identified by name, ports by their component, service path and name, and channels by their endpoints; a channel whose endpoints stay but whose ConnPolicy changed is a policy change.
+ *  Applying the records in order to the base snapshot gives back the next snapshot exactly, including the order of its components, ports and channels, so a recording can hold one full snapshot followed by deltas only.
+ *  Records refer to components, ports and channels by their position, see Op for which positions they use.
+ */
+class DotDelta
+{
+  public:
+    enum Op
+    {
+        /// Remove the component at index of the base snapshot, together with its ports
+        RemoveComponent,
+        /// Insert component name in cluster path with TaskState value at final index
+        AddComponent,
+        /// Set the TaskState of the component at final index to value
+        SetState,
+        /// Remove the port at index among the base ports of the component at final index component
+        RemovePort,
+        /// Insert port path.name with Direction value at final index among the ports of the component at final index component
+        AddPort,
+        /// Remove the channel at index of the base snapshot
+        RemoveChannel,
+        /// Insert channels()[value] at final index; its endpoints are final port indices
+        AddChannel,
+        /// Set the ConnPolicy of the channel at final index to the one of channels()[value]
+        SetPolicy,
+        /// Move the component at final index to cluster path
+        SetCluster
+    };
+
+    struct Record
+    {
+        uint32_t op;
+        uint32_t index;
+        uint32_t component;
+        /// String ids
+        uint32_t name;
+        uint32_t path;
+        int32_t value;
+    };
+
+    DotDelta();
+
+    uint64_t timestamp;
+    uint64_t base_structure_hash;
+    uint64_t base_state_hash;
+    uint64_t structure_hash;
+    uint64_t state_hash;
+
+    const std::vector<Record>& records() const { return m_records; }
+    const std::vector<DotGraph::Channel>& channels() const { return m_channels; }
+    bool empty() const { return m_records.empty(); }
+
+    /// Compute the changes from base to current, which have to share their string table like copies made with DotGraph::assign()
+    void compute(const DotGraph& base, const DotGraph& current);
+
+    /** \brief Turn graph into the next snapshot
+     *
+     *  @param graph the base snapshot, holding the strings the records refer to
+     *  @return false, leaving graph untouched, if graph is not the base of this delta or a record does not fit it
+     */
+    bool apply(DotGraph& graph) const;
+
+    /// Append the binary layout of the delta, graph provides the strings
+    void render(const DotGraph& graph, DotWriter& out);
+
+    /** \brief Read a binary delta
+     *
+     *  Its strings are added to the string table of graph, so that the delta can be applied to it.
+     *  @return false if data does not hold a valid delta
+     */
+    bool read(const char* data, size_t size, DotGraph& graph);
+
+  private:
+    struct ChannelKey
+    {
+        unsigned int writer_comp, writer_path, writer_name;
+        unsigned int reader_comp, reader_path, reader_name;
+        bool at_input_port;
+        bool operator==(const ChannelKey& o) const
+        {
+            return writer_comp == o.writer_comp && writer_path == o.writer_path && writer_name == o.writer_name
+                && reader_comp == o.reader_comp && reader_path == o.reader_path && reader_name == o.reader_name
+                && at_input_port == o.at_input_port;
+        }
+    };
+    struct ChannelKeyHash
+    {
+        size_t operator()(const ChannelKey& k) const;
+    };
+    static ChannelKey channelKey(const DotGraph& graph, const DotGraph::Channel& ch);
+    static bool samePolicy(const DotGraph::Channel& a, const DotGraph::Channel& b);
+    void add(Op op, uint32_t index, uint32_t component = 0, uint32_t name = 0, uint32_t path = 0, int32_t value = 0);
+
+    std::vector<Record> m_records;
+    std::vector<DotGraph::Channel> m_channels;
+
+    // Scratch tables of compute() and render(), reused across calls
+    std::vector<unsigned int> m_base_component;
+    std::vector<unsigned int> m_kept_component;
+    std::vector<unsigned int> m_base_port;
+    std::vector<bool> m_kept_port;
+    std::vector<unsigned int> m_base_channel;
+    std::vector<unsigned int> m_same_key;
+    std::vector<bool> m_kept_channel;
+    DotFlatMap<ChannelKey, ChannelKeyHash> m_channel_index;
+    std::vector<unsigned int> m_local;
+    std::vector<const std::string*> m_used;
+};
+#endif
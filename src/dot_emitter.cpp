@@ -0,0 +1,637 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_emitter.hpp"
+#include <rtt/ConnPolicy.hpp>
+#include <rtt/base/TaskCore.hpp>
+
+using namespace RTT;
+
+const char* DotEmitter::stateColor(int state, bool hex)
+{
+    switch (state)
+    {
+        case base::TaskCore::Init          : return hex ? "#ffffff" : "white";
+        case base::TaskCore::PreOperational: return hex ? "#ffa500" : "orange";
+        case base::TaskCore::FatalError    : return hex ? "#ff0000" : "red";
+        case base::TaskCore::Exception     : return hex ? "#ff0000" : "red";
+        case base::TaskCore::Stopped       : return hex ? "#add8e6" : "lightblue";
+        case base::TaskCore::Running       : return "#4ec167";
+        case base::TaskCore::RunTimeError  : return hex ? "#ff0000" : "red";
+    }
+    // Falls back to the node fillcolor
+    return hex ? "#eeeeee" : "";
+}
+
+void DotEmitter::colorPlaceholder(unsigned int index, char color[8])
+{
+    static const char digits[] = "0123456789abcdef";
+    unsigned int v = index + 1;
+    color[0] = '#';
+    for(int i = 6; i > 0; i--)
+    {
+        color[i] = digits[v & 15];
+        v >>= 4;
+    }
+    color[7] = '\0';
+}
+
+void DotEmitter::heatColor(double load, char color[8])
+{
+    static const char digits[] = "0123456789abcdef";
+    if(load < 0)
+        load = 0;
+    if(load > 1)
+        load = 1;
+    // #4ec167 at 0, #ffd700 at 0.5, #ff0000 at 1
+    int rgb[3];
+    if(load < 0.5)
+    {
+        double t = load * 2;
+        rgb[0] = int(0x4e + (0xff - 0x4e) * t);
+        rgb[1] = int(0xc1 + (0xd7 - 0xc1) * t);
+        rgb[2] = int(0x67 - 0x67 * t);
+    }
+    else
+    {
+        double t = load * 2 - 1;
+        rgb[0] = 0xff;
+        rgb[1] = int(0xd7 - 0xd7 * t);
+        rgb[2] = 0;
+    }
+    color[0] = '#';
+    for(int i = 0; i < 3; i++)
+    {
+        color[1 + 2 * i] = digits[rgb[i] >> 4];
+        color[2 + 2 * i] = digits[rgb[i] & 15];
+    }
+    color[7] = '\0';
+}
+
+void DotEmitter::timingLabel(const DotGraph& graph, const DotGraph::Timing& timing, DotWriter& out)
+{
+    out << "\\n" << graph.str(timing.activity);
+    if(timing.period > 0)
+    {
+        out << " " << timing.period * 1e3 << "ms";
+    }
+    out << (timing.realtime ? " RT " : " OTHER ") << timing.priority;
+    if(timing.cpu_affinity != ~0u)
+    {
+        out << " cpus " << timing.cpu_affinity;
+    }
+    if(timing.thread_users > 1)
+    {
+        out << " shared by " << timing.thread_users;
+    }
+    if(timing.steps > 0)
+    {
+        out << "\\nmean " << timing.mean_us << "us max " << timing.max_us << "us load " << int(timing.load * 100 + 0.5) << "%";
+    }
+}
+
+const char* DotEmitter::transportName(int transport)
+{
+    switch(transport)
+    {
+        case 1: return "CORBA";
+        case 2: return "MQ";
+        case 3: return "ROS";
+    }
+    return 0;
+}
+
+void DotEmitter::transportLabel(int transport, const std::string& conn_args, DotWriter& out)
+{
+    const char* name = transportName(transport);
+    if(name)
+    {
+        out << " [" << conn_args << "label=" << name << ",style=dashed];";
+    }
+    out << "\n";
+}
+
+double DotEmitter::pressure(const DotGraph::ChannelStats& stats)
+{
+    if(stats.capacity == 0)
+        return -1;
+    // Dropping beats any fill level
+    return (stats.drop_rate > 0 ? 2.0 : 0.0) + double(stats.fill) / stats.capacity;
+}
+
+void DotEmitter::statsAttributes(const Edge& e, const DotGraph::ChannelStats& stats, bool counted, const DotOptions& options, DotWriter& out)
+{
+    double fill = double(stats.fill) / stats.capacity;
+    const char* color = e.bold ? "#2a4563" : "#000000";
+    if(stats.drop_rate > 0)
+        color = "#ff0000";
+    else if(fill >= 0.8)
+        color = "#ffa500";
+    if(e.bold)
+        out << " [style=bold";
+    else
+        out << " [" << options.conn_args << "style=dashed";
+    out << ",color=\"" << color << "\",penwidth=" << 1 + 4 * fill << ",label=\"";
+    const char* transport = transportName(e.transport);
+    if(counted)
+        out << e.count << ": ";
+    else if(!e.bold && transport)
+        out << transport << ": ";
+    out << stats.fill << "/" << stats.capacity;
+    if(stats.dropped > 0)
+        out << ", " << stats.dropped << " dropped";
+    if(stats.drop_rate > 0)
+        out << " (" << stats.drop_rate << "/s)";
+    out << "\"];\n";
+}
+
+void DotEmitter::endpoint(const DotGraph& graph, unsigned int port, unsigned int comp, DotWriter& out)
+{
+    if(port == DotGraph::npos)
+    {
+        out.quoted(graph.str(comp));
+        return;
+    }
+    const DotGraph::Port& p = graph.ports()[port];
+    out.quoted(graph.str(graph.components()[p.component].name)) << ":" << (p.direction == DotGraph::Input ? "i" : "o") << p.field;
+}
+
+void DotEmitter::portLabel(const DotGraph& graph, const DotGraph::Port& port, DotWriter& out)
+{
+    // Ports of sub-services are prefixed with the service path, so equally named ports stay distinguishable
+    if(port.path != DotGraph::empty)
+    {
+        out << graph.str(port.path) << ".";
+    }
+    out << graph.str(port.name);
+}
+
+void DotEmitter::placeholderStates(const DotGraph& graph, std::vector<int>& states)
+{
+    const std::vector<DotGraph::Component>& components = graph.components();
+    groupClusters(graph);
+    states.resize(components.size() + m_clusters.size());
+    for(unsigned int i = 0; i < components.size(); i++)
+        states[i] = components[i].state;
+    for(unsigned int k = 0; k < m_clusters.size(); k++)
+        states[components.size() + k] = m_clusters[k].state;
+}
+
+int DotEmitter::severity(int state)
+{
+    switch (state)
+    {
+        case base::TaskCore::Running       : return 1;
+        case base::TaskCore::Init          : return 2;
+        case base::TaskCore::Stopped       : return 3;
+        case base::TaskCore::PreOperational: return 4;
+        case base::TaskCore::RunTimeError  : return 5;
+        case base::TaskCore::Exception     : return 6;
+        case base::TaskCore::FatalError    : return 7;
+    }
+    return 0;
+}
+
+void DotEmitter::groupClusters(const DotGraph& graph)
+{
+    const std::vector<DotGraph::Component>& components = graph.components();
+    m_clusters.clear();
+    m_cluster_index.clear();
+    m_component_cluster.assign(components.size(), DotGraph::npos);
+    for(unsigned int i = 0; i < components.size(); i++)
+    {
+        const DotGraph::Component& comp = components[i];
+        if(comp.cluster == DotGraph::empty)
+            continue;
+        unsigned int k = m_cluster_index.find(comp.cluster);
+        if(k == DotGraph::npos)
+        {
+            k = m_clusters.size();
+            Cluster cluster = { comp.cluster, 0, 0, 0, comp.state };
+            m_clusters.push_back(cluster);
+            m_cluster_index.insert(comp.cluster, k);
+        }
+        Cluster& cluster = m_clusters[k];
+        cluster.size++;
+        if(severity(comp.state) > severity(cluster.state))
+            cluster.state = comp.state;
+        m_component_cluster[i] = k;
+    }
+
+    // Counting sort of the members, clusters in order of their first member
+    unsigned int first = 0;
+    for(unsigned int k = 0; k < m_clusters.size(); k++)
+    {
+        Cluster& cluster = m_clusters[k];
+        cluster.first = cluster.end = first;
+        if(cluster.size > 1)
+            first += cluster.size;
+    }
+    m_order.resize(first);
+    for(unsigned int i = 0; i < components.size(); i++)
+    {
+        unsigned int k = m_component_cluster[i];
+        if(k == DotGraph::npos)
+            continue;
+        if(m_clusters[k].size < 2)
+            m_component_cluster[i] = DotGraph::npos;
+        else
+            m_order[m_clusters[k].end++] = i;
+    }
+}
+
+void DotEmitter::node(const DotGraph& graph, unsigned int index, const DotOptions& options, DotWriter& out)
+{
+    const std::vector<DotGraph::Port>& ports = graph.ports();
+    const DotGraph::Component& comp = graph.components()[index];
+
+    const DotGraph::Timing* timing = 0;
+    if(options.timing && index < graph.timings().size() && graph.timings()[index].activity != DotGraph::empty)
+    {
+        timing = &graph.timings()[index];
+    }
+    char placeholder[8];
+    const char* color = stateColor(comp.state);
+    // Measured loads are part of the snapshot's state, so they are never recolored from placeholders
+    if(timing && timing->steps > 0)
+    {
+        heatColor(timing->load, placeholder);
+        color = placeholder;
+    }
+    else if(options.color_placeholders)
+    {
+        colorPlaceholder(index, placeholder);
+        color = placeholder;
+    }
+
+    // Record fields come from the port table: inputs on the left, outputs on the right
+    unsigned int end = comp.first_port + comp.num_ports;
+    out.quoted(graph.str(comp.name)) << "[shape=record,fillcolor=\""<<color<<"\",label=\"\\N";
+    if(timing)
+    {
+        timingLabel(graph, *timing, out);
+    }
+    out << "|{{";
+    for(unsigned int j = comp.first_port; j < end; j++)
+    {
+        const DotGraph::Port& port = ports[j];
+        if(port.direction == DotGraph::Input)
+        {
+            out << (port.field>0 ? " | ":"") << "<i" << port.field <<">";
+            portLabel(graph, port, out);
+        }
+    }
+    out << " } | | { ";
+    for(unsigned int j = comp.first_port; j < end; j++)
+    {
+        const DotGraph::Port& port = ports[j];
+        if(port.direction == DotGraph::Output)
+        {
+            out << (port.field>0 ? " | ":"") << "<o" << port.field <<">";
+            portLabel(graph, port, out);
+        }
+    }
+    out << "}}\"];\n";
+}
+
+bool DotEmitter::edge(const DotGraph::Channel& ch, End& from, End& to, bool& bold)
+{
+    // Channels are unique in the graph, so they are drawn from whichever end they were found at
+    if(!ch.hasWriter()){
+      from.port = DotGraph::npos;
+      from.name = ch.name_id;
+      to.port = ch.reader;
+      to.name = ch.reader_comp;
+      bold = false;
+      return ch.hasReader();
+    }
+    from.port = ch.writer;
+    from.name = ch.writer_comp;
+    // If the ConnPolicy has a non-empty name, use that name as the topic name
+    if(ch.name_id != DotGraph::empty){
+      to.port = DotGraph::npos;
+      to.name = ch.name_id;
+      bold = ch.hasReader();
+      return true;
+    }
+    // A stream without a name has nothing to point to
+    if(!ch.hasReader()){
+      return false;
+    }
+    to.port = ch.reader;
+    to.name = ch.reader_comp;
+    bold = true;
+    return true;
+}
+
+// Node of an edge end: 0 and a port, 1 and a name, 2 and a collapsed cluster or 3 and a fan-out hub in the upper 32 bits
+uint64_t DotEmitter::edgeEnd(const DotGraph& graph, const End& end, bool collapse)
+{
+    if(end.port == DotGraph::npos)
+        return (uint64_t(1) << 32) | end.name;
+    unsigned int k = collapse ? m_component_cluster[graph.ports()[end.port].component] : DotGraph::npos;
+    if(k == DotGraph::npos)
+        return end.port;
+    return (uint64_t(2) << 32) | k;
+}
+
+void DotEmitter::endNode(const DotGraph& graph, uint64_t end, DotWriter& out)
+{
+    unsigned int id = unsigned(end);
+    switch(unsigned(end >> 32))
+    {
+        case 0:
+          endpoint(graph, id, DotGraph::npos, out);
+          break;
+        case 1:
+          out.quoted(graph.str(id));
+          break;
+        case 2:
+          m_cluster_node.assign("cluster_");
+          m_cluster_node += graph.str(m_clusters[id].name);
+          out.quoted(m_cluster_node);
+          break;
+        default:
+          out << "\"fanout_" << id << "\"";
+          break;
+    }
+}
+
+void DotEmitter::edges(const DotGraph& graph, const DotOptions& options, bool collapse, DotWriter& out)
+{
+  const std::vector<DotGraph::Channel>& channels = graph.channels();
+
+  m_channel_edges.clear();
+  m_fanouts.clear();
+  m_fanout_index.clear();
+  for(unsigned int i = 0; i < channels.size(); i++)
+  {
+    const DotGraph::Channel& ch = channels[i];
+    End from, to;
+    bool bold;
+    if(!edge(ch, from, to, bold))
+      continue;
+    unsigned int stats = options.channel_stats && i < graph.channelStats().size() && graph.channelStats()[i].capacity > 0 ? i : DotGraph::npos;
+    Edge e = { edgeEnd(graph, from, collapse), edgeEnd(graph, to, collapse), 1, bold, ch.transport, stats };
+    // Connections inside a collapsed cluster are hidden
+    if(e.from == e.to && (e.from >> 32) == 2)
+      continue;
+    unsigned int fanout = DotGraph::npos;
+    // Count the local subscribers of every output with the same policy
+    if(options.bundle_fanout > 0 && bold && ch.name_id == DotGraph::empty)
+    {
+      Fanout f = { e.from, ch.type, ch.size, ch.lock_policy, 0 };
+      fanout = m_fanout_index.find(f);
+      if(fanout == DotGraph::npos)
+      {
+        fanout = m_fanouts.size();
+        m_fanout_index.insert(f, fanout);
+        m_fanouts.push_back(f);
+      }
+      m_fanouts[fanout].count++;
+    }
+    ChannelEdge ce = { e, fanout };
+    m_channel_edges.push_back(ce);
+  }
+
+  // Outputs with enough subscribers point to a single hub, which points to every subscriber
+  for(unsigned int k = 0; k < m_fanouts.size(); k++)
+  {
+    const Fanout& f = m_fanouts[k];
+    if(f.count < options.bundle_fanout)
+      continue;
+    endNode(graph, (uint64_t(3) << 32) | k, out);
+    out << "[shape=ellipse,style=dashed,label=\"" << f.count << " subscribers\\n" << typeName(f.type);
+    if(f.type != ConnPolicy::DATA)
+      out << "[" << f.size << "]";
+    out << "\"];\n";
+  }
+
+  // Connections between the same nodes become one edge labelled with their number
+  m_edges.clear();
+  m_edge_index.clear();
+  for(unsigned int i = 0; i < m_channel_edges.size(); i++)
+  {
+    Edge e = m_channel_edges[i].edge;
+    unsigned int fanout = m_channel_edges[i].fanout;
+    if(fanout != DotGraph::npos && m_fanouts[fanout].count >= options.bundle_fanout)
+    {
+      // The hub carries the policy, its edges to the subscribers only show who is connected
+      Edge subscriber = { (uint64_t(3) << 32) | fanout, e.to, 1, false, e.transport, DotGraph::npos };
+      e.to = subscriber.from;
+      mergeEdge(graph, e);
+      mergeEdge(graph, subscriber);
+      continue;
+    }
+    mergeEdge(graph, e);
+  }
+  for(unsigned int i = 0; i < m_edges.size(); i++)
+  {
+    const Edge& e = m_edges[i];
+    endNode(graph, e.from, out);
+    out << " -> ";
+    endNode(graph, e.to, out);
+    // The hub is labelled with the number of subscribers already
+    bool counted = e.count > 1 && (e.to >> 32) != 3;
+    if((e.from >> 32) == 3)
+    {
+      out << " [color=\"#2a4563\"";
+      if(counted)
+        out << ",label=\"" << e.count << "\"";
+      out << "];\n";
+    }
+    else if(e.stats != DotGraph::npos)
+      statsAttributes(e, graph.channelStats()[e.stats], counted, options, out);
+    else if(e.bold)
+    {
+      out << " [color=\"#2a4563\",style=bold";
+      if(counted)
+        out << ",label=\"" << e.count << "\"";
+      out << "];\n";
+    }
+    else if(counted)
+      out << " [" << options.conn_args << "label=\"" << e.count << "\",style=dashed];\n";
+    else
+      transportLabel(e.transport, options.conn_args, out);
+  }
+}
+
+void DotEmitter::mergeEdge(const DotGraph& graph, const Edge& e)
+{
+  unsigned int k = m_edge_index.find(e);
+  if(k == DotGraph::npos)
+  {
+    m_edge_index.insert(e, m_edges.size());
+    m_edges.push_back(e);
+    return;
+  }
+  Edge& merged = m_edges[k];
+  merged.count++;
+  merged.bold = merged.bold || e.bold;
+  if(e.stats != DotGraph::npos && (merged.stats == DotGraph::npos || pressure(graph.channelStats()[e.stats]) > pressure(graph.channelStats()[merged.stats])))
+    merged.stats = e.stats;
+}
+
+uint64_t DotEmitter::componentEnd(const DotGraph& graph, unsigned int component, bool collapse)
+{
+    unsigned int k = collapse ? m_component_cluster[component] : DotGraph::npos;
+    if(k == DotGraph::npos)
+        return (uint64_t(1) << 32) | graph.components()[component].name;
+    return (uint64_t(2) << 32) | k;
+}
+
+void DotEmitter::calls(const DotGraph& graph, bool collapse, DotWriter& out)
+{
+  const std::vector<DotGraph::Call>& calls = graph.calls();
+  m_call_groups.clear();
+  m_call_index.clear();
+  m_call_group.assign(calls.size(), DotGraph::npos);
+  for(unsigned int i = 0; i < calls.size(); i++)
+  {
+    const DotGraph::Call& call = calls[i];
+    uint64_t from = componentEnd(graph, call.caller, collapse);
+    uint64_t to = call.callee != DotGraph::npos ? componentEnd(graph, call.callee, collapse) : (uint64_t(1) << 32) | call.callee_name;
+    // Calls inside a collapsed cluster are hidden
+    if(from == to && (from >> 32) == 2)
+      continue;
+    CallGroup group = { from, to, call.remote ? 2 : call.own_thread ? 1 : 0, call.guessed, 0, 0, 0 };
+    unsigned int k = m_call_index.find(group);
+    if(k == DotGraph::npos)
+    {
+      k = m_call_groups.size();
+      m_call_index.insert(group, k);
+      m_call_groups.push_back(group);
+    }
+    m_call_groups[k].size++;
+    m_call_group[i] = k;
+  }
+
+  // Counting sort of the calls by group
+  unsigned int first = 0;
+  for(unsigned int k = 0; k < m_call_groups.size(); k++)
+  {
+    m_call_groups[k].first = m_call_groups[k].end = first;
+    first += m_call_groups[k].size;
+  }
+  m_call_order.resize(first);
+  for(unsigned int i = 0; i < calls.size(); i++)
+    if(m_call_group[i] != DotGraph::npos)
+      m_call_order[m_call_groups[m_call_group[i]].end++] = i;
+
+  for(unsigned int k = 0; k < m_call_groups.size(); k++)
+  {
+    const CallGroup& group = m_call_groups[k];
+    endNode(graph, group.from, out);
+    out << " -> ";
+    endNode(graph, group.to, out);
+    switch(group.thread)
+    {
+      case 1:
+        // Every call is a hop through the callee's queue
+        out << " [color=\"#c0392b\",style=\"dashed,bold\",label=\"OwnThread";
+        break;
+      case 2:
+        out << " [color=\"#7f8c8d\",style=dashed,label=\"remote";
+        break;
+      default:
+        out << " [color=\"#7f8c8d\",style=dotted,label=\"ClientThread";
+        break;
+    }
+    if(group.guessed)
+      out << " (callee guessed)";
+    for(unsigned int j = group.first; j < group.end; j++)
+    {
+      const DotGraph::Call& call = calls[m_call_order[j]];
+      out << "\\n";
+      if(call.service != DotGraph::empty)
+        out << graph.str(call.service) << ".";
+      out << graph.str(call.operation);
+    }
+    out << "\",arrowhead=vee,constraint=false];\n";
+  }
+}
+
+void DotEmitter::render(const DotGraph& graph, const DotOptions& options, DotWriter& out)
+{
+  out << "digraph G { \n";
+  out << "graph[splines=true, overlap=false] \n";
+  out << "rankdir=LR; \n";
+  out << "nodesep=0.5; \n";
+  out << "ranksep=1.5; \n";
+  out << "fontname=\"sans\";\n";
+  // out << "labelloc=\"t\";\n";
+  // out << "fontsize=25;\n";
+  // out << "label=" << this->getOwner()->getName()<<";\n";
+  out << "node [style=\"rounded,filled\",fontsize=15,color=\"#777777\",fillcolor=\"#eeeeee\"];\n";
+
+  const std::vector<DotGraph::Component>& components = graph.components();
+
+  groupClusters(graph);
+  bool collapse = options.collapse_clusters && !m_order.empty();
+
+  for(unsigned int i = 0; i < components.size(); i++)
+    if(m_component_cluster[i] == DotGraph::npos)
+      node(graph, i, options, out);
+  for(unsigned int k = 0; k < m_clusters.size(); k++)
+  {
+    const Cluster& cluster = m_clusters[k];
+    if(cluster.size < 2)
+      continue;
+    if(collapse)
+    {
+      char placeholder[8];
+      const char* color = stateColor(cluster.state);
+      if(options.color_placeholders)
+      {
+        colorPlaceholder(components.size() + k, placeholder);
+        color = placeholder;
+      }
+      endNode(graph, (uint64_t(2) << 32) | k, out);
+      out << "[shape=box3d,fillcolor=\"" << color << "\",label=";
+      out.quoted(graph.str(cluster.name)) << "];\n";
+      continue;
+    }
+    out << "subgraph ";
+    endNode(graph, (uint64_t(2) << 32) | k, out);
+    out << " {\nlabel=";
+    out.quoted(graph.str(cluster.name)) << ";\n";
+    for(unsigned int j = cluster.first; j < cluster.end; j++)
+      node(graph, m_order[j], options, out);
+    out << "}\n";
+  }
+
+  edges(graph, options, collapse, out);
+  calls(graph, collapse, out);
+  out << "}\n";
+}
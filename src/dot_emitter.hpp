@@ -0,0 +1,181 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief DOT formatting of a deployment snapshot
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_EMITTER_HPP
+#define DOT_EMITTER_HPP
+
+#include "dot_backend.hpp"
+#include "dot_flat_map.hpp"
+#include <stdint.h>
+
+/** \brief Formats a DotGraph in the DOT language
+ *
+ *  Components of the same cluster are drawn in a "cluster_" subgraph, or as a single node if DotOptions::collapse_clusters is set. A cluster of a single component is not drawn.
+ *  Operation calls are drawn as one edge per caller, callee and thread the operations run in, labelled with the operations, without constraining the layout. Calls whose callee is a guess among several providers are drawn apart and marked as such.
+ *  Connections between the same two nodes are drawn as one edge labelled with their number. Outputs with at least DotOptions::bundle_fanout local subscribers of the same policy are drawn as a single edge, labelled with the policy, to a "fanout_" hub node, from which a plain edge leads to every subscriber.
+ */
+class DotEmitter : public DotBackend {
+  public:
+    void render(const DotGraph& graph, const DotOptions& options, DotWriter& out);
+
+    /// Fill color of a component in TaskState state, as a color name or in the 7 character form "#rrggbb"
+    static const char* stateColor(int state, bool hex = false);
+    /// Placeholder fill color "#rrggbb" of component index, numbered from #000001 so it is never the default black
+    static void colorPlaceholder(unsigned int index, char color[8]);
+    /// Fill color "#rrggbb" of a load between 0 and 1, from green over yellow to red
+    static void heatColor(double load, char color[8]);
+    /// TaskState behind every placeholder color: one per component, followed by one per collapsed cluster
+    void placeholderStates(const DotGraph& graph, std::vector<int>& states);
+
+  private:
+    /// End of an edge: a port, or a plain node drawn by name
+    struct End
+    {
+        unsigned int port;
+        unsigned int name;
+    };
+    struct Cluster
+    {
+        unsigned int name;
+        unsigned int size;
+        /// Members are m_order[first] up to m_order[end]
+        unsigned int first;
+        unsigned int end;
+        int state;
+    };
+    /// Edge between collapsed nodes, with the number of connections it stands for
+    struct Edge
+    {
+        uint64_t from;
+        uint64_t to;
+        unsigned int count;
+        bool bold;
+        int transport;
+        /// Channel whose buffer state is drawn, the fullest one; DotGraph::npos if none
+        unsigned int stats;
+        bool operator==(const Edge& o) const { return from == o.from && to == o.to; }
+    };
+    struct IdHash
+    {
+        size_t operator()(unsigned int id) const { return id; }
+    };
+    struct EdgeHash
+    {
+        size_t operator()(const Edge& e) const { return size_t(e.from * 1000003 + e.to); }
+    };
+    /// Subscribers of an output with the same policy
+    struct Fanout
+    {
+        uint64_t from;
+        int type;
+        int size;
+        int lock_policy;
+        unsigned int count;
+        bool operator==(const Fanout& o) const { return from == o.from && type == o.type && size == o.size && lock_policy == o.lock_policy; }
+    };
+    struct FanoutHash
+    {
+        size_t operator()(const Fanout& f) const { return size_t((f.from * 31 + f.type) * 1000003 + f.size); }
+    };
+    /// Calls between the same nodes running in the same thread; members are m_call_order[first] up to m_call_order[end]
+    struct CallGroup
+    {
+        uint64_t from;
+        uint64_t to;
+        /// 0 for ClientThread, 1 for OwnThread, 2 for remote operations
+        int thread;
+        /// The callee of the calls is a guess among several providers
+        bool guessed;
+        unsigned int size;
+        unsigned int first;
+        unsigned int end;
+        bool operator==(const CallGroup& o) const { return from == o.from && to == o.to && thread == o.thread && guessed == o.guessed; }
+    };
+    struct CallGroupHash
+    {
+        size_t operator()(const CallGroup& g) const { return size_t(((g.from * 1000003 + g.to) * 3 + g.thread) * 2 + g.guessed); }
+    };
+    /// Edge of a channel and its index in m_fanouts, DotGraph::npos if it is not bundled
+    struct ChannelEdge
+    {
+        Edge edge;
+        unsigned int fanout;
+    };
+
+    void groupClusters(const DotGraph& graph);
+    void node(const DotGraph& graph, unsigned int index, const DotOptions& options, DotWriter& out);
+    bool edge(const DotGraph::Channel& ch, End& from, End& to, bool& bold);
+    uint64_t edgeEnd(const DotGraph& graph, const End& end, bool collapse);
+    void endNode(const DotGraph& graph, uint64_t end, DotWriter& out);
+    void edges(const DotGraph& graph, const DotOptions& options, bool collapse, DotWriter& out);
+    /// Add e to m_edges, or count it in the edge between the same nodes
+    void mergeEdge(const DotGraph& graph, const Edge& e);
+    uint64_t componentEnd(const DotGraph& graph, unsigned int component, bool collapse);
+    void calls(const DotGraph& graph, bool collapse, DotWriter& out);
+    /// Order in which a cluster is colored by the states of its members, the highest wins
+    static int severity(int state);
+
+    // Clusters found by groupClusters(), reused across calls
+    std::vector<Cluster> m_clusters;
+    DotFlatMap<unsigned int, IdHash> m_cluster_index;
+    /// Index in m_clusters of every component, DotGraph::npos if it is drawn on its own
+    std::vector<unsigned int> m_component_cluster;
+    /// Components ordered by cluster
+    std::vector<unsigned int> m_order;
+    std::vector<ChannelEdge> m_channel_edges;
+    std::vector<Fanout> m_fanouts;
+    DotFlatMap<Fanout, FanoutHash> m_fanout_index;
+    std::vector<Edge> m_edges;
+    DotFlatMap<Edge, EdgeHash> m_edge_index;
+    std::vector<CallGroup> m_call_groups;
+    DotFlatMap<CallGroup, CallGroupHash> m_call_index;
+    /// Index in m_call_groups of every call, DotGraph::npos if it is hidden
+    std::vector<unsigned int> m_call_group;
+    std::vector<unsigned int> m_call_order;
+    std::string m_cluster_node;
+
+    void endpoint(const DotGraph& graph, unsigned int port, unsigned int comp, DotWriter& out);
+    void portLabel(const DotGraph& graph, const DotGraph::Port& port, DotWriter& out);
+    void timingLabel(const DotGraph& graph, const DotGraph::Timing& timing, DotWriter& out);
+    void transportLabel(int transport, const std::string& conn_args, DotWriter& out);
+    static const char* transportName(int transport);
+    /// Attributes of an edge carrying the buffer state of a channel
+    void statsAttributes(const Edge& e, const DotGraph::ChannelStats& stats, bool counted, const DotOptions& options, DotWriter& out);
+    /// Order in which the buffer states of merged channels are drawn, the highest wins
+    static double pressure(const DotGraph::ChannelStats& stats);
+};
+#endif
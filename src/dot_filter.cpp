@@ -0,0 +1,81 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_filter.hpp"
+#include <rtt/Logger.hpp>
+
+using namespace RTT;
+
+bool DotFilter::set(const std::string& include, const std::string& exclude)
+{
+    if(include == m_include && exclude == m_exclude)
+    {
+        return false;
+    }
+    m_include = include;
+    m_exclude = exclude;
+    compile(include, m_include_re, m_has_include);
+    compile(exclude, m_exclude_re, m_has_exclude);
+    m_generation++;
+    return true;
+}
+
+bool DotFilter::compile(const std::string& expression, std::regex& re, bool& has)
+{
+    has = false;
+    if(expression.empty())
+    {
+        return true;
+    }
+    try
+    {
+        re.assign(expression, std::regex::extended | std::regex::optimize);
+        has = true;
+        return true;
+    }
+    catch(const std::regex_error& e)
+    {
+        log(Error) << "Invalid filter expression '" << expression << "': " << e.what() << endlog();
+        return false;
+    }
+}
+
+bool DotFilter::accept(const std::string& name) const
+{
+    if(m_has_include && !std::regex_search(name, m_include_re))
+    {
+        return false;
+    }
+    return !(m_has_exclude && std::regex_search(name, m_exclude_re));
+}
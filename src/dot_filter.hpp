@@ -0,0 +1,79 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Name filters of the OROCOS dot service
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_FILTER_HPP
+#define DOT_FILTER_HPP
+
+#include <regex>
+#include <string>
+
+/** \brief Include and exclude regular expressions on names
+ *
+ *  A name is accepted if it matches the include expression, or there is none, and it does not match the exclude expression.
+ *  Expressions are searched in the name, use ^ and $ to match it as a whole. The filter can be used from several threads at once, as long as it is not being set.
+ */
+class DotFilter {
+  public:
+    DotFilter() : m_has_include(false), m_has_exclude(false), m_generation(0) {}
+
+    /** \brief Compile new expressions, if they differ from the current ones
+     *
+     *  An invalid expression is reported and ignored.
+     *  @return true if the filter changed
+     */
+    bool set(const std::string& include, const std::string& exclude);
+
+    /// False if every name is accepted
+    bool active() const { return m_has_include || m_has_exclude; }
+
+    bool accept(const std::string& name) const;
+
+    /// Incremented every time the filter changes, to invalidate cached verdicts
+    unsigned int generation() const { return m_generation; }
+
+  private:
+    bool compile(const std::string& expression, std::regex& re, bool& has);
+
+    std::string m_include;
+    std::string m_exclude;
+    std::regex m_include_re;
+    std::regex m_exclude_re;
+    bool m_has_include;
+    bool m_has_exclude;
+    unsigned int m_generation;
+};
+#endif
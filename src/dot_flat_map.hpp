@@ -0,0 +1,134 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Open addressing hash index that keeps its memory when cleared
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_FLAT_MAP_HPP
+#define DOT_FLAT_MAP_HPP
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/** \brief Hash index from a key to an unsigned int id
+ *
+ *  Linear probing in a single vector. clear() is O(1) and releases nothing, so once the index has grown to the size of the deployment, rebuilding it does not allocate.
+ */
+template<class Key, class Hash>
+class DotFlatMap
+{
+  public:
+    static const unsigned int npos = ~0u;
+
+    DotFlatMap() : m_size(0), m_generation(1) {}
+
+    void clear()
+    {
+        m_size = 0;
+        if(++m_generation == 0)
+        {
+            // wrapped around, mark every slot as free for real
+            for(size_t i = 0; i < m_slots.size(); i++)
+                m_slots[i].generation = 0;
+            m_generation = 1;
+        }
+    }
+
+    size_t size() const { return m_size; }
+
+    /// Insert or overwrite the id of key
+    void insert(const Key& key, unsigned int value)
+    {
+        if((m_size + 1) * 2 > m_slots.size())
+            grow();
+        Slot& slot = m_slots[probe(key)];
+        if(slot.generation != m_generation)
+        {
+            slot.generation = m_generation;
+            slot.key = key;
+            m_size++;
+        }
+        slot.value = value;
+    }
+
+    /// Id of key, npos if it is not in the index
+    unsigned int find(const Key& key) const
+    {
+        if(m_slots.empty())
+            return npos;
+        const Slot& slot = m_slots[probe(key)];
+        return slot.generation == m_generation ? slot.value : npos;
+    }
+
+  private:
+    struct Slot
+    {
+        Key key;
+        unsigned int value;
+        unsigned int generation;
+    };
+
+    size_t probe(const Key& key) const
+    {
+        size_t mask = m_slots.size() - 1;
+        // Fibonacci hashing spreads aligned pointers and small ids over the table
+        size_t i = size_t((uint64_t(Hash()(key)) * 0x9E3779B97F4A7C15ULL) >> 20) & mask;
+        while(m_slots[i].generation == m_generation && !(m_slots[i].key == key))
+            i = (i + 1) & mask;
+        return i;
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old;
+        old.swap(m_slots);
+        unsigned int old_generation = m_generation;
+        Slot free_slot = Slot();
+        m_slots.assign(old.empty() ? 64 : old.size() * 2, free_slot);
+        m_generation = 1;
+        m_size = 0;
+        for(size_t i = 0; i < old.size(); i++)
+            if(old[i].generation == old_generation)
+                insert(old[i].key, old[i].value);
+    }
+
+    std::vector<Slot> m_slots;
+    size_t m_size;
+    unsigned int m_generation;
+};
+
+template<class Key, class Hash>
+const unsigned int DotFlatMap<Key, Hash>::npos;
+#endif
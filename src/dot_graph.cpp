@@ -0,0 +1,175 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_graph.hpp"
+
+const unsigned int DotGraph::npos;
+const unsigned int DotGraph::empty;
+
+DotGraph::DotGraph()
+    : timestamp(0), structure_hash(0), state_hash(0)
+{
+    intern("");
+}
+
+unsigned int DotGraph::intern(const std::string& name)
+{
+    std::unordered_map<std::string, unsigned int>::const_iterator it = m_string_index.find(name);
+    if(it != m_string_index.end())
+    {
+        return it->second;
+    }
+    unsigned int id = m_strings.size();
+    m_strings.push_back(name);
+    m_string_index.insert(std::make_pair(name, id));
+    return id;
+}
+
+unsigned int DotGraph::addComponent(unsigned int name, int state, unsigned int cluster)
+{
+    Component comp;
+    comp.name = name;
+    comp.state = state;
+    comp.cluster = cluster;
+    comp.first_port = m_ports.size();
+    comp.num_ports = 0;
+    m_components.push_back(comp);
+    m_component_index.insert(name, m_components.size() - 1);
+    return m_components.size() - 1;
+}
+
+unsigned int DotGraph::addPort(unsigned int path, unsigned int name, Direction direction, unsigned int field)
+{
+    Port port;
+    port.name = name;
+    port.path = path;
+    port.direction = direction;
+    port.field = field;
+    port.component = m_components.size() - 1;
+    m_ports.push_back(port);
+    m_components.back().num_ports++;
+    PortKey key = { port.component, path, name };
+    m_port_index.insert(key, m_ports.size() - 1);
+    return m_ports.size() - 1;
+}
+
+size_t DotGraph::ChannelKeyHash::operator()(const ChannelKey& k) const
+{
+    size_t h = (size_t(k.writer) * 31 + k.reader) * 1000003 + k.name_id;
+    h = (h * 31 + k.writer_comp) * 31 + k.reader_comp;
+    return ((h * 31 + k.type) * 31 + k.size) * 31 + k.transport;
+}
+
+unsigned int DotGraph::addChannel(const Channel& channel)
+{
+    ChannelKey key = { channel.writer, channel.reader, channel.writer_comp, channel.reader_comp, channel.name_id,
+                       channel.type, channel.size, channel.lock_policy, channel.transport, channel.init, channel.pull };
+    unsigned int index = m_channel_index.find(key);
+    if(index != DotGraph::npos)
+    {
+        // Seen from its other end
+        m_channels[index].at_input_port = m_channels[index].at_input_port || channel.at_input_port;
+        return index;
+    }
+    m_channels.push_back(channel);
+    m_channel_index.insert(key, m_channels.size() - 1);
+    return m_channels.size() - 1;
+}
+
+unsigned int DotGraph::addCall(const Call& call)
+{
+    m_calls.push_back(call);
+    return m_calls.size() - 1;
+}
+
+void DotGraph::setChannelStats(unsigned int channel, const ChannelStats& stats)
+{
+    m_channel_stats.resize(m_channels.size(), ChannelStats());
+    m_channel_stats[channel] = stats;
+}
+
+void DotGraph::setTiming(unsigned int component, const Timing& timing)
+{
+    m_timings.resize(m_components.size(), Timing());
+    m_timings[component] = timing;
+}
+
+unsigned int DotGraph::findComponent(unsigned int name) const
+{
+    return m_component_index.find(name);
+}
+
+unsigned int DotGraph::findPort(unsigned int component, unsigned int path, unsigned int name) const
+{
+    PortKey key = { component, path, name };
+    return m_port_index.find(key);
+}
+
+void DotGraph::clear()
+{
+    m_components.clear();
+    m_ports.clear();
+    m_channels.clear();
+    m_calls.clear();
+    m_channel_stats.clear();
+    m_timings.clear();
+    m_component_index.clear();
+    m_port_index.clear();
+    m_channel_index.clear();
+}
+
+void DotGraph::assign(const DotGraph& other)
+{
+    if(this == &other)
+    {
+        return;
+    }
+    for(unsigned int i = m_strings.size(); i < other.m_strings.size(); i++)
+    {
+        m_strings.push_back(other.m_strings[i]);
+        m_string_index.insert(std::make_pair(other.m_strings[i], i));
+    }
+    timestamp = other.timestamp;
+    structure_hash = other.structure_hash;
+    state_hash = other.state_hash;
+    m_components = other.m_components;
+    m_ports = other.m_ports;
+    m_channels = other.m_channels;
+    m_calls = other.m_calls;
+    m_channel_stats = other.m_channel_stats;
+    m_timings = other.m_timings;
+    m_component_index = other.m_component_index;
+    m_port_index = other.m_port_index;
+    m_channel_index = other.m_channel_index;
+}
@@ -0,0 +1,264 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Deployment snapshot drawn by the OROCOS dot service
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_GRAPH_HPP
+#define DOT_GRAPH_HPP
+
+#include "dot_flat_map.hpp"
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** \brief Snapshot of a deployment configuration
+ *
+ *  Captured from the peer components in Dot::execute() and rendered afterwards, possibly in another thread. It does not hold any pointers into the deployment, so it stays valid when components or connections go away.
+ *  All names are interned in a string table and referred to by id. Components, ports and channels live in dense vectors and are referred to by their index; ports are grouped per component.
+ *  The graph is meant to be rebuilt in place: clear() drops the structure but keeps the string table, so ids of names stay stable and no memory is released between captures.
+ *  Once it has grown to the size of the deployment, rebuilding it only allocates for names it has not seen before.
+ */
+class DotGraph
+{
+  public:
+    enum Direction { Input, Output };
+
+    /// Index used for ids that do not refer to anything
+    static const unsigned int npos = ~0u;
+
+    struct Component
+    {
+        unsigned int name;
+        /// RTT::base::TaskCore::TaskState of the component
+        int state;
+        /// String id of the cluster the component is drawn in, empty if it is not clustered
+        unsigned int cluster;
+        /// Range of the component's ports in the port table
+        unsigned int first_port;
+        unsigned int num_ports;
+    };
+
+    struct Port
+    {
+        unsigned int name;
+        /// Path of the sub-service providing the port, the empty string for the component itself
+        unsigned int path;
+        Direction direction;
+        /// Position among the component's ports of the same direction, gives the record field i<field> or o<field>
+        unsigned int field;
+        /// Index of the owning component
+        unsigned int component;
+    };
+
+    struct Channel
+    {
+        /// Ports writing into and reading from the channel, npos if they are not part of the graph
+        unsigned int writer;
+        unsigned int reader;
+        /// Owner of an endpoint port that is not part of the graph, npos if the endpoint is not local
+        unsigned int writer_comp;
+        unsigned int reader_comp;
+        /// True if the channel was found at an input port, false if only at an output port
+        bool at_input_port;
+        /// RTT::ConnPolicy fields
+        int type;
+        int size;
+        int lock_policy;
+        int transport;
+        bool init;
+        bool pull;
+        unsigned int name_id;
+
+        bool hasWriter() const { return writer != npos || writer_comp != npos; }
+        bool hasReader() const { return reader != npos || reader_comp != npos; }
+    };
+
+    /// Operation a component calls on another one through an OperationCaller
+    struct Call
+    {
+        /// Index of the calling component
+        unsigned int caller;
+        /// Index of the component providing the operation, npos if it is not part of the graph
+        unsigned int callee;
+        /// Name of the providing component if it is not part of the graph, npos otherwise
+        unsigned int callee_name;
+        /// String ids of the required service, empty for the component's own requester, and of the operation
+        unsigned int service;
+        unsigned int operation;
+        /// True if the operation runs in the callee's thread (OwnThread), so every call is queued to it
+        bool own_thread;
+        /// True if the operation is not local, so its thread is not known
+        bool remote;
+        /// True if several components provide the operation, so the callee is only the first of them
+        bool guessed;
+    };
+
+    /// Buffer state of a channel
+    struct ChannelStats
+    {
+        /// Capacity of the channel's buffer, 0 if it has none that could be sampled
+        unsigned int capacity;
+        /// Samples in the buffer
+        unsigned int fill;
+        /// Samples dropped since the connection was made
+        unsigned int dropped;
+        /// Samples dropped per second over the last measurement window
+        double drop_rate;
+    };
+
+    /// Activity running a component and the measured cost of its steps
+    struct Timing
+    {
+        /// String id of the kind of activity, e.g. "Activity" or "SlaveActivity"; empty if the timing was not captured
+        unsigned int activity;
+        /// Period in seconds, 0 if the activity is not periodic
+        double period;
+        bool realtime;
+        int priority;
+        unsigned int cpu_affinity;
+        /// Number of components run by the same thread, including this one
+        unsigned int thread_users;
+        /// Number of steps in the measurement window, 0 if nothing was measured
+        unsigned int steps;
+        /// CPU time of the thread per step, in microseconds
+        double mean_us;
+        double max_us;
+        /// CPU time of the thread relative to the length of the window
+        double load;
+    };
+
+    DotGraph();
+
+    /// Time of the capture in nanoseconds
+    uint64_t timestamp;
+    /// Fingerprints of the wiring and of the task states at the time of the capture
+    uint64_t structure_hash;
+    uint64_t state_hash;
+
+    /// Id of a name, adding it to the string table if needed
+    unsigned int intern(const std::string& name);
+    const std::string& str(unsigned int id) const { return m_strings[id]; }
+    const std::vector<std::string>& strings() const { return m_strings; }
+    /// Id of the empty string
+    static const unsigned int empty = 0;
+
+    const std::vector<Component>& components() const { return m_components; }
+    const std::vector<Port>& ports() const { return m_ports; }
+    const std::vector<Channel>& channels() const { return m_channels; }
+    /// Operation calls between components, empty if they were not captured
+    const std::vector<Call>& calls() const { return m_calls; }
+    /// Buffer state of every channel, empty if it was not captured
+    const std::vector<ChannelStats>& channelStats() const { return m_channel_stats; }
+    /// Timing of every component, empty if it was not captured
+    const std::vector<Timing>& timings() const { return m_timings; }
+
+    /** Add a component, its ports have to be added right after it
+     *  @return the component's index
+     */
+    unsigned int addComponent(unsigned int name, int state, unsigned int cluster = empty);
+    /// Add a port to the last added component, returns its index
+    unsigned int addPort(unsigned int path, unsigned int name, Direction direction, unsigned int field);
+    /** Add a channel, or merge it into the equal one added before
+     *
+     *  A connection between two ports of the graph is found at both of them; channels with the same endpoints and policy are kept once, so every connection appears exactly once.
+     *  @return the channel's index
+     */
+    unsigned int addChannel(const Channel& channel);
+    /// Add an operation call, returns its index
+    unsigned int addCall(const Call& call);
+    /// Set the buffer state of a channel, the other channels get an empty one
+    void setChannelStats(unsigned int channel, const ChannelStats& stats);
+    /// Set the timing of a component, the other components get an empty one
+    void setTiming(unsigned int component, const Timing& timing);
+
+    /// Index of a component by name, npos if unknown
+    unsigned int findComponent(unsigned int name) const;
+    /// Index of a port by owning component, service path and name, npos if unknown
+    unsigned int findPort(unsigned int component, unsigned int path, unsigned int name) const;
+
+    /// Remove all components, ports and channels, keeping the string table
+    void clear();
+
+    /** Make this graph a copy of another one
+     *
+     *  The string table only grows, so only the strings this graph does not have yet are copied.
+     */
+    void assign(const DotGraph& other);
+
+  private:
+    struct PortKey
+    {
+        unsigned int component, path, name;
+        bool operator==(const PortKey& o) const { return component == o.component && path == o.path && name == o.name; }
+    };
+    struct PortKeyHash
+    {
+        size_t operator()(const PortKey& k) const { return (size_t(k.component) * 31 + k.path) * 1000003 + k.name; }
+    };
+    struct IdHash
+    {
+        size_t operator()(unsigned int id) const { return id; }
+    };
+    struct ChannelKey
+    {
+        unsigned int writer, reader, writer_comp, reader_comp, name_id;
+        int type, size, lock_policy, transport;
+        bool init, pull;
+        bool operator==(const ChannelKey& o) const
+        {
+            return writer == o.writer && reader == o.reader && writer_comp == o.writer_comp && reader_comp == o.reader_comp
+                && name_id == o.name_id && type == o.type && size == o.size && lock_policy == o.lock_policy
+                && transport == o.transport && init == o.init && pull == o.pull;
+        }
+    };
+    struct ChannelKeyHash
+    {
+        size_t operator()(const ChannelKey& k) const;
+    };
+
+    std::vector<std::string> m_strings;
+    std::unordered_map<std::string, unsigned int> m_string_index;
+    std::vector<Component> m_components;
+    std::vector<Port> m_ports;
+    std::vector<Channel> m_channels;
+    std::vector<Call> m_calls;
+    std::vector<ChannelStats> m_channel_stats;
+    std::vector<Timing> m_timings;
+    DotFlatMap<unsigned int, IdHash> m_component_index;
+    DotFlatMap<PortKey, PortKeyHash> m_port_index;
+    DotFlatMap<ChannelKey, ChannelKeyHash> m_channel_index;
+};
+#endif
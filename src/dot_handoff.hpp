@@ -0,0 +1,95 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Lock-free handoff of snapshots between two threads
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_HANDOFF_HPP
+#define DOT_HANDOFF_HPP
+
+#include <atomic>
+
+/** \brief Single-producer/single-consumer triple buffer
+ *
+ *  The producer fills back() and publishes it, the consumer takes the newest published slot with consume() and reads it through front().
+ *  Neither side ever blocks: a slot that was published but not yet consumed is replaced by the next one, so only the newest snapshot is kept.
+ *  Slots are reused, so T can keep its allocated memory across snapshots.
+ */
+template<class T>
+class DotHandoff
+{
+  public:
+    DotHandoff() : m_back(0), m_middle(1), m_front(2) {}
+
+    /// Slot owned by the producer
+    T& back() { return m_slots[m_back]; }
+
+    /** Hand back() over to the consumer
+     *  @return false if a previously published slot was not consumed yet and got dropped
+     */
+    bool publish()
+    {
+        unsigned int prev = m_middle.exchange(m_back | fresh, std::memory_order_acq_rel);
+        m_back = prev & index_mask;
+        return (prev & fresh) == 0;
+    }
+
+    /** Take the newest published slot
+     *  @return false if nothing was published since the last call
+     */
+    bool consume()
+    {
+        if((m_middle.load(std::memory_order_relaxed) & fresh) == 0)
+            return false;
+        unsigned int prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = prev & index_mask;
+        return true;
+    }
+
+    /// Slot owned by the consumer
+    const T& front() const { return m_slots[m_front]; }
+
+  private:
+    DotHandoff(const DotHandoff&);
+    DotHandoff& operator=(const DotHandoff&);
+
+    static const unsigned int index_mask = 3;
+    static const unsigned int fresh = 4;
+
+    T m_slots[3];
+    unsigned int m_back;
+    std::atomic<unsigned int> m_middle;
+    unsigned int m_front;
+};
+#endif
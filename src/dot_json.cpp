@@ -0,0 +1,134 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_json.hpp"
+
+void DotJsonEmitter::endpoint(const DotGraph& graph, unsigned int port, unsigned int comp, DotWriter& out)
+{
+    if(port != DotGraph::npos)
+    {
+        const DotGraph::Port& p = graph.ports()[port];
+        out << "{\"component\":";
+        out.jsonString(graph.str(graph.components()[p.component].name)) << ",\"path\":";
+        out.jsonString(graph.str(p.path)) << ",\"port\":";
+        out.jsonString(graph.str(p.name)) << "}";
+    }
+    else if(comp != DotGraph::npos)
+    {
+        out << "{\"component\":";
+        out.jsonString(graph.str(comp)) << "}";
+    }
+    else
+    {
+        out << "null";
+    }
+}
+
+void DotJsonEmitter::render(const DotGraph& graph, const DotOptions&, DotWriter& out)
+{
+    const std::vector<DotGraph::Component>& components = graph.components();
+    const std::vector<DotGraph::Port>& ports = graph.ports();
+    const std::vector<DotGraph::Channel>& channels = graph.channels();
+
+    out << "{\n\"timestamp\":" << (unsigned long long)graph.timestamp;
+    out << ",\n\"structure_hash\":\"";
+    out.hex(graph.structure_hash) << "\",\n\"state_hash\":\"";
+    out.hex(graph.state_hash) << "\",\n\"components\":[";
+    for(unsigned int i = 0; i < components.size(); i++)
+    {
+        const DotGraph::Component& comp = components[i];
+        out << (i > 0 ? ",\n" : "\n") << "{\"name\":";
+        out.jsonString(graph.str(comp.name)) << ",\"state\":\"" << stateName(comp.state) << "\",";
+        if(comp.cluster != DotGraph::empty)
+        {
+            out << "\"cluster\":";
+            out.jsonString(graph.str(comp.cluster)) << ",";
+        }
+        if(i < graph.timings().size() && graph.timings()[i].activity != DotGraph::empty)
+        {
+            const DotGraph::Timing& t = graph.timings()[i];
+            out << "\"timing\":{\"activity\":";
+            out.jsonString(graph.str(t.activity)) << ",\"period\":";
+            out.jsonNumber(t.period) << ",\"realtime\":" << (t.realtime ? "true" : "false");
+            out << ",\"priority\":" << t.priority << ",\"cpu_affinity\":" << t.cpu_affinity << ",\"thread_users\":" << t.thread_users;
+            out << ",\"steps\":" << t.steps << ",\"mean_us\":";
+            out.jsonNumber(t.mean_us) << ",\"max_us\":";
+            out.jsonNumber(t.max_us) << ",\"load\":";
+            out.jsonNumber(t.load) << "},";
+        }
+        out << "\"ports\":[";
+        for(unsigned int j = comp.first_port; j < comp.first_port + comp.num_ports; j++)
+        {
+            const DotGraph::Port& port = ports[j];
+            out << (j > comp.first_port ? "," : "") << "{\"name\":";
+            out.jsonString(graph.str(port.name)) << ",\"path\":";
+            out.jsonString(graph.str(port.path)) << ",\"direction\":\"" << (port.direction == DotGraph::Input ? "in" : "out") << "\"}";
+        }
+        out << "]}";
+    }
+    out << "],\n\"channels\":[";
+    for(unsigned int i = 0; i < channels.size(); i++)
+    {
+        const DotGraph::Channel& ch = channels[i];
+        out << (i > 0 ? ",\n" : "\n") << "{\"writer\":";
+        endpoint(graph, ch.writer, ch.writer_comp, out);
+        out << ",\"reader\":";
+        endpoint(graph, ch.reader, ch.reader_comp, out);
+        out << ",\"at_input_port\":" << (ch.at_input_port ? "true" : "false");
+        out << ",\"type\":\"" << typeName(ch.type) << "\",\"size\":" << ch.size;
+        out << ",\"lock_policy\":" << ch.lock_policy << ",\"transport\":" << ch.transport;
+        out << ",\"init\":" << (ch.init ? "true" : "false") << ",\"pull\":" << (ch.pull ? "true" : "false");
+        out << ",\"name_id\":";
+        out.jsonString(graph.str(ch.name_id));
+        if(i < graph.channelStats().size() && graph.channelStats()[i].capacity > 0)
+        {
+            const DotGraph::ChannelStats& s = graph.channelStats()[i];
+            out << ",\"stats\":{\"capacity\":" << s.capacity << ",\"fill\":" << s.fill << ",\"dropped\":" << s.dropped << ",\"drop_rate\":";
+            out.jsonNumber(s.drop_rate) << "}";
+        }
+        out << "}";
+    }
+    out << "],\n\"calls\":[";
+    const std::vector<DotGraph::Call>& calls = graph.calls();
+    for(unsigned int i = 0; i < calls.size(); i++)
+    {
+        const DotGraph::Call& call = calls[i];
+        out << (i > 0 ? ",\n" : "\n") << "{\"caller\":";
+        out.jsonString(graph.str(components[call.caller].name)) << ",\"callee\":";
+        out.jsonString(graph.str(call.callee != DotGraph::npos ? components[call.callee].name : call.callee_name)) << ",\"service\":";
+        out.jsonString(graph.str(call.service)) << ",\"operation\":";
+        out.jsonString(graph.str(call.operation)) << ",\"thread\":\"" << (call.remote ? "unknown" : call.own_thread ? "own" : "client") << "\",\"guessed\":" << (call.guessed ? "true" : "false") << "}";
+    }
+    out << "]\n}\n";
+}
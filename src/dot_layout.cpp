@@ -0,0 +1,346 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_layout.hpp"
+#include <rtt/Logger.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace RTT;
+
+const unsigned int DotLayoutCache::max_layouts;
+
+namespace {
+const char layout_prefix[] = "rtt_dot_";
+const char layout_suffix[] = ".layout";
+
+const uint64_t fnv_offset = 14695981039346656037ULL;
+const uint64_t fnv_prime = 1099511628211ULL;
+
+void hashBytes(uint64_t& h, const void* data, size_t len)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for(size_t i = 0; i < len; ++i)
+    {
+        h ^= p[i];
+        h *= fnv_prime;
+    }
+}
+
+int hexDigit(char c)
+{
+    if(c >= '0' && c <= '9')
+        return c - '0';
+    if(c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+void appendQuoted(std::string& cmd, const std::string& arg)
+{
+    cmd += '\'';
+    for(std::string::const_iterator it = arg.begin(); it != arg.end(); ++it)
+    {
+        if(*it == '\'')
+            cmd += "'\\''";
+        else
+            cmd += *it;
+    }
+    cmd += '\'';
+}
+}
+
+DotLayoutCache::DotLayoutCache()
+    : m_valid(false), m_structure(0), m_key(0)
+{
+}
+
+std::string DotLayoutCache::defaultCacheDir()
+{
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    if(xdg && *xdg)
+    {
+        return std::string(xdg) + "/rtt_dot";
+    }
+    const char* home = getenv("HOME");
+    if(home && *home)
+    {
+        return std::string(home) + "/.cache/rtt_dot";
+    }
+    return std::string();
+}
+
+bool DotLayoutCache::write(const DotGraph& graph, const DotOptions& options, const std::string& command, const std::string& cache_dir, const std::string& path, DotWriter& out)
+{
+    // The task states are the only input of the DOT file that does not change the structure
+    uint64_t structure = fnv_offset;
+    hashBytes(structure, &graph.structure_hash, sizeof(graph.structure_hash));
+    hashBytes(structure, options.conn_args.data(), options.conn_args.size());
+    hashBytes(structure, &options.collapse_clusters, sizeof(options.collapse_clusters));
+    hashBytes(structure, &options.bundle_fanout, sizeof(options.bundle_fanout));
+    hashBytes(structure, command.data(), command.size() + 1);
+    const std::string& dir = cache_dir.empty() ? defaultCacheDir() : cache_dir;
+    if(!m_valid || structure != m_structure || dir != m_cache_dir)
+    {
+        m_valid = false;
+        m_structure = structure;
+        m_cache_dir = dir;
+        if(!load(graph, options, command, out))
+        {
+            return false;
+        }
+        m_valid = true;
+    }
+
+    out.clear();
+    out.append(m_layout.data(), m_layout.size());
+    m_emitter.placeholderStates(graph, m_states);
+    for(size_t i = 0; i < m_fills.size(); i++)
+    {
+        out.overwrite(m_fills[i].offset, DotEmitter::stateColor(m_states[m_fills[i].component], true), 7);
+    }
+    return out.writeFile(path);
+}
+
+bool DotLayoutCache::load(const DotGraph& graph, const DotOptions& options, const std::string& command, DotWriter& out)
+{
+    if(!privateDir())
+    {
+        return false;
+    }
+    // Render the graph with placeholder colors, without the annotations that change with every measurement; its text names the layout
+    DotOptions placeholders(options);
+    placeholders.color_placeholders = true;
+    placeholders.timing = false;
+    placeholders.channel_stats = false;
+    out.clear();
+    m_emitter.render(graph, placeholders, out);
+    m_key = fnv_offset;
+    hashBytes(m_key, out.data(), out.size());
+    hashBytes(m_key, command.data(), command.size() + 1);
+    char name[40];
+    snprintf(name, sizeof(name), "/%s%016llx%s", layout_prefix, (unsigned long long)m_key, layout_suffix);
+    m_cache_file.assign(m_cache_dir);
+    m_cache_file.append(name);
+
+    bool missing = false;
+    if(readFile(m_cache_file, missing))
+    {
+        // Most recently used layouts are evicted last
+        utimensat(AT_FDCWD, m_cache_file.c_str(), 0, AT_SYMLINK_NOFOLLOW);
+    }
+    else if(!missing)
+    {
+        log(Error) << "Unable to read file: " << m_cache_file << endlog();
+        return false;
+    }
+    else
+    {
+        // Not laid out yet: run Graphviz on the rendered graph
+        m_input_file.assign(m_cache_dir);
+        m_input_file.append("/input_XXXXXX");
+        int fd = mkstemp(&m_input_file[0]);
+        bool written = fd >= 0 && out.writeTo(fd);
+        if(fd >= 0 && ::close(fd) != 0)
+        {
+            written = false;
+        }
+        if(!written)
+        {
+            log(Error) << "Unable to write file: " << m_input_file << endlog();
+            if(fd >= 0)
+                unlink(m_input_file.c_str());
+            return false;
+        }
+        m_tmp_file.assign(m_cache_dir);
+        m_tmp_file.append("/layout_XXXXXX");
+        fd = mkstemp(&m_tmp_file[0]);
+        if(fd < 0)
+        {
+            log(Error) << "Unable to create file: " << m_tmp_file << endlog();
+            unlink(m_input_file.c_str());
+            return false;
+        }
+        ::close(fd);
+        m_command_line.assign(command);
+        m_command_line.append(" -o ");
+        appendQuoted(m_command_line, m_tmp_file);
+        m_command_line += ' ';
+        appendQuoted(m_command_line, m_input_file);
+        log(Debug) << "Laying out the deployment: " << m_command_line << endlog();
+        int ret = system(m_command_line.c_str());
+        unlink(m_input_file.c_str());
+        if(ret != 0 || rename(m_tmp_file.c_str(), m_cache_file.c_str()) != 0)
+        {
+            log(Error) << "Layout command failed: " << m_command_line << endlog();
+            unlink(m_tmp_file.c_str());
+            return false;
+        }
+        evict();
+        if(!readFile(m_cache_file, missing))
+        {
+            log(Error) << "Unable to read file: " << m_cache_file << endlog();
+            return false;
+        }
+    }
+
+    // Graphviz copies the placeholders into attributes ("#000001") and xdot drawing operations (-#000001)
+    m_emitter.placeholderStates(graph, m_states);
+    unsigned int num_placeholders = m_states.size();
+    m_fills.clear();
+    for(size_t i = 1; i + 7 <= m_layout.size(); i++)
+    {
+        if(m_layout[i] != '#' || (m_layout[i - 1] != '"' && m_layout[i - 1] != '-'))
+        {
+            continue;
+        }
+        unsigned int v = 0;
+        int j = 1;
+        for(; j < 7; j++)
+        {
+            int d = hexDigit(m_layout[i + j]);
+            if(d < 0)
+                break;
+            v = v * 16 + d;
+        }
+        if(j == 7 && v >= 1 && v <= num_placeholders && (i + 7 == m_layout.size() || hexDigit(m_layout[i + 7]) < 0))
+        {
+            Fill fill = { i, v - 1 };
+            m_fills.push_back(fill);
+        }
+    }
+    return true;
+}
+
+bool DotLayoutCache::privateDir()
+{
+    if(m_cache_dir.empty())
+    {
+        log(Error) << "No layout cache directory: neither layout_cache_dir, XDG_CACHE_HOME nor HOME is set" << endlog();
+        return false;
+    }
+    if(mkdir(m_cache_dir.c_str(), 0700) != 0 && errno == ENOENT)
+    {
+        // The parent of the default directory, ~/.cache, may not exist yet
+        std::string::size_type slash = m_cache_dir.find_last_of('/');
+        if(slash != std::string::npos && slash > 0)
+        {
+            mkdir(m_cache_dir.substr(0, slash).c_str(), 0700);
+        }
+        mkdir(m_cache_dir.c_str(), 0700);
+    }
+    struct stat st;
+    if(lstat(m_cache_dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & 077) != 0)
+    {
+        log(Error) << "Not caching layouts in " << m_cache_dir << ": it has to be a directory of this user that nobody else can access (mode 0700)" << endlog();
+        return false;
+    }
+    return true;
+}
+
+void DotLayoutCache::evict()
+{
+    DIR* dir = opendir(m_cache_dir.c_str());
+    if(!dir)
+    {
+        return;
+    }
+    std::vector<std::pair<time_t, std::string> > layouts;
+    size_t prefix = sizeof(layout_prefix) - 1;
+    size_t suffix = sizeof(layout_suffix) - 1;
+    std::string path;
+    while(dirent* entry = readdir(dir))
+    {
+        size_t len = strlen(entry->d_name);
+        if(len <= prefix + suffix || strncmp(entry->d_name, layout_prefix, prefix) != 0 || strcmp(entry->d_name + len - suffix, layout_suffix) != 0)
+        {
+            continue;
+        }
+        path = m_cache_dir + "/" + entry->d_name;
+        struct stat st;
+        if(lstat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+        {
+            layouts.push_back(std::make_pair(st.st_mtime, path));
+        }
+    }
+    closedir(dir);
+    if(layouts.size() <= max_layouts)
+    {
+        return;
+    }
+    std::sort(layouts.begin(), layouts.end());
+    for(size_t i = 0; i + max_layouts < layouts.size(); i++)
+    {
+        unlink(layouts[i].second.c_str());
+    }
+}
+
+bool DotLayoutCache::readFile(const std::string& path, bool& missing)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_NOFOLLOW);
+    missing = fd < 0 && errno == ENOENT;
+    if(fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid())
+    {
+        ::close(fd);
+        return false;
+    }
+    m_layout.clear();
+    char buf[65536];
+    ssize_t n;
+    while((n = ::read(fd, buf, sizeof(buf))) != 0)
+    {
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            ::close(fd);
+            return false;
+        }
+        m_layout.append(buf, n);
+    }
+    ::close(fd);
+    return true;
+}
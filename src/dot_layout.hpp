@@ -0,0 +1,109 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Graphviz layout of a deployment snapshot, cached per wiring
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_LAYOUT_HPP
+#define DOT_LAYOUT_HPP
+
+#include "dot_emitter.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** \brief Lays out the DOT graph once per wiring and recolors it for every task state change
+ *
+ *  Positions do not depend on the fill colors, so the graph is laid out with a placeholder color per component (see DotEmitter::colorPlaceholder()).
+ *  The result is cached on disk under a key derived from the DOT text given to Graphviz, which only depends on the names, ports and policies of the deployment, so a restarted deployment finds its layout again. The structure fingerprint of the snapshot is not stable across runs, it only tells when the text has to be rendered and hashed again.
+ *  As long as the wiring does not change, a new snapshot only replaces the placeholders by the colors of the current task states, which have the same length.
+ *  Timing and buffer annotations change with every measurement, so they are left out of the layout; it only shows the wiring and the task states.
+ *  The cache directory has to be private to the user, it is created with mode 0700 if needed. Only the max_layouts most recently used layouts are kept in it.
+ *  Laying out runs Graphviz and waits for it, so write() must not be called from a real-time thread.
+ */
+class DotLayoutCache {
+  public:
+    DotLayoutCache();
+
+    /// Number of layouts kept in the cache directory
+    static const unsigned int max_layouts = 64;
+    /// Cache directory used for an empty cache_dir: $XDG_CACHE_HOME/rtt_dot, or ~/.cache/rtt_dot
+    static std::string defaultCacheDir();
+
+    /** \brief Write the laid out graph, colored by the current task states
+     *
+     *  @param graph the deployment snapshot
+     *  @param options output settings captured with the snapshot
+     *  @param command Graphviz command producing the layout, e.g. "dot -Txdot"; it is passed "-o output input"
+     *  @param cache_dir directory holding the cached layouts, empty for defaultCacheDir()
+     *  @param path file to write the colored layout to
+     *  @param out buffer used to format the output
+     *  @return false if the layout could not be made or written
+     */
+    bool write(const DotGraph& graph, const DotOptions& options, const std::string& command, const std::string& cache_dir, const std::string& path, DotWriter& out);
+
+  private:
+    /// Position of a placeholder in the layout
+    struct Fill
+    {
+        size_t offset;
+        /// Placeholder index, see DotEmitter::placeholderStates()
+        unsigned int component;
+    };
+
+    bool load(const DotGraph& graph, const DotOptions& options, const std::string& command, DotWriter& out);
+    /// Create m_cache_dir if needed, false if it is not a directory that only this user can access
+    bool privateDir();
+    /// Read a regular file of this user into m_layout, without following symbolic links
+    bool readFile(const std::string& path, bool& missing);
+    /// Remove the least recently used layouts beyond max_layouts
+    void evict();
+
+    DotEmitter m_emitter;
+    bool m_valid;
+    /// Structure fingerprint and options the current layout was made for
+    uint64_t m_structure;
+    /// Hash of the DOT text laid out, naming the cache file
+    uint64_t m_key;
+    std::string m_command;
+    std::string m_cache_dir;
+    std::string m_layout;
+    std::vector<Fill> m_fills;
+    std::vector<int> m_states;
+    std::string m_cache_file;
+    std::string m_tmp_file;
+    std::string m_input_file;
+    std::string m_command_line;
+};
+#endif
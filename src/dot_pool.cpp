@@ -0,0 +1,124 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_pool.hpp"
+#include <rtt/Logger.hpp>
+
+using namespace RTT;
+
+DotPool::DotPool()
+    : m_scheduler(ORO_SCHED_OTHER)
+    ,m_priority(0)
+    ,m_cpu_affinity(~0u)
+    ,m_job(0)
+    ,m_count(0)
+    ,m_next(0)
+    ,m_generation(0)
+    ,m_done(0)
+{
+}
+
+DotPool::~DotPool()
+{
+    resize(0, m_scheduler, m_priority, m_cpu_affinity);
+}
+
+bool DotPool::resize(unsigned int threads, int scheduler, int priority, unsigned int cpu_affinity)
+{
+    if(threads == m_threads.size() && scheduler == m_scheduler && priority == m_priority && cpu_affinity == m_cpu_affinity)
+    {
+        return true;
+    }
+    for(unsigned int i = 0; i < m_threads.size(); i++)
+    {
+        m_threads[i]->stop();
+    }
+    m_threads.clear();
+    m_runners.clear();
+    m_scheduler = scheduler;
+    m_priority = priority;
+    m_cpu_affinity = cpu_affinity;
+    for(unsigned int i = 0; i < threads; i++)
+    {
+        m_runners.push_back(std::unique_ptr<Runner>(new Runner(this)));
+        m_threads.push_back(std::unique_ptr<Activity>(new Activity(scheduler, priority, 0.0, cpu_affinity, m_runners.back().get(), "DotPool")));
+        if(!m_threads.back()->start())
+        {
+            log(Error) << "Unable to start a dot scan thread" << endlog();
+            m_threads.pop_back();
+            m_runners.pop_back();
+            return false;
+        }
+    }
+    return true;
+}
+
+void DotPool::run(Job& job, unsigned int count)
+{
+    m_job = &job;
+    m_count = count;
+    m_next.store(0);
+    m_generation.fetch_add(1);
+    for(unsigned int i = 0; i < m_threads.size(); i++)
+    {
+        m_threads[i]->trigger();
+    }
+    work();
+    for(unsigned int i = 0; i < m_threads.size(); i++)
+    {
+        m_done.wait();
+    }
+    m_job = 0;
+}
+
+void DotPool::work()
+{
+    for(unsigned int i = m_next.fetch_add(1); i < m_count; i = m_next.fetch_add(1))
+    {
+        m_job->run(i);
+    }
+}
+
+void DotPool::Runner::step()
+{
+    // Activities also step when they are started, only join runs that were not joined yet
+    unsigned int generation = m_pool->m_generation.load();
+    if(generation == m_generation)
+    {
+        return;
+    }
+    m_generation = generation;
+    m_pool->work();
+    m_pool->m_done.signal();
+}
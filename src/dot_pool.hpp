@@ -0,0 +1,106 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Small pool of threads sharing the work of a scan
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_POOL_HPP
+#define DOT_POOL_HPP
+
+#include <rtt/Activity.hpp>
+#include <rtt/base/RunnableInterface.hpp>
+#include <rtt/os/Semaphore.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/** \brief Runs a job for a range of indices on a few worker threads and the calling thread
+ *
+ *  Indices are handed out one at a time, so a slow index does not hold up the others. The job has to write the result of every index to its own place; the order in which indices run is not defined.
+ */
+class DotPool {
+  public:
+    /// Work done for each index
+    class Job {
+      public:
+        virtual ~Job() {}
+        virtual void run(unsigned int index) = 0;
+    };
+
+    DotPool();
+    ~DotPool();
+
+    /** \brief Set the number of worker threads running besides the calling thread
+     *
+     *  run() waits for the worker threads, so they should not have a lower priority than the calling thread.
+     *  @param scheduler ORO_SCHED_RT or ORO_SCHED_OTHER
+     *  @return false if a thread could not be started
+     */
+    bool resize(unsigned int threads, int scheduler, int priority, unsigned int cpu_affinity);
+    unsigned int size() const { return m_threads.size(); }
+
+    /// Run job for every index below count and return once all of them are done
+    void run(Job& job, unsigned int count);
+
+  private:
+    class Runner : public RTT::base::RunnableInterface {
+      public:
+        /// A runner added after earlier runs only joins the runs posted from now on
+        Runner(DotPool* pool) : m_pool(pool), m_generation(pool->m_generation.load()) {}
+        bool initialize() { return true; }
+        void step();
+        void finalize() {}
+      private:
+        DotPool* m_pool;
+        /// Last run() this runner took part in
+        unsigned int m_generation;
+    };
+
+    void work();
+
+    std::vector<std::unique_ptr<Runner> > m_runners;
+    std::vector<std::unique_ptr<RTT::Activity> > m_threads;
+    int m_scheduler;
+    int m_priority;
+    unsigned int m_cpu_affinity;
+
+    Job* m_job;
+    unsigned int m_count;
+    std::atomic<unsigned int> m_next;
+    /// Counts the calls of run(), so that a runner joins every run exactly once
+    std::atomic<unsigned int> m_generation;
+    /// Signalled by every runner once it finished its part of a run
+    RTT::os::Semaphore m_done;
+};
+#endif
@@ -0,0 +1,237 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_recorder.hpp"
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const uint32_t DotRecordingHeader::current_version;
+
+namespace {
+const char magic[8] = { 'R', 'T', 'T', 'D', 'O', 'T', 'R', '\0' };
+/// Type of the frame marking the skipped end of the ring
+const uint32_t padding_frame = 0;
+}
+
+DotRecorder::DotRecorder()
+    : m_size(0), m_map(0), m_header(0), m_ring(0), m_since_snapshot(0)
+{
+}
+
+DotRecorder::~DotRecorder()
+{
+    close();
+}
+
+uint32_t DotRecorder::frameLength(uint32_t size)
+{
+    return (sizeof(DotBinaryFrame) + size + 7) & ~7u;
+}
+
+uint32_t DotRecorder::wrap(const char* ring, uint32_t capacity, uint32_t offset)
+{
+    if(capacity - offset < sizeof(DotBinaryFrame))
+    {
+        return 0;
+    }
+    DotBinaryFrame frame;
+    memcpy(&frame, ring + offset, sizeof(frame));
+    return frame.type == padding_frame ? 0 : offset;
+}
+
+bool DotRecorder::open(const std::string& path, size_t size)
+{
+    close();
+    if(path.empty())
+    {
+        return true;
+    }
+    if(size < sizeof(DotRecordingHeader) + sizeof(DotBinaryFrame) || size > 0xffffffffu)
+    {
+        return false;
+    }
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    bool resize = fstat(fd, &st) != 0 || size_t(st.st_size) != size;
+    if(resize && ftruncate(fd, size) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* map = mmap(0, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    ::close(fd);
+    if(map == MAP_FAILED)
+    {
+        return false;
+    }
+    // Keeps the pages resident, appending would wait for the disk otherwise; needs enough RLIMIT_MEMLOCK
+    mlock(map, size);
+
+    std::vector<Frame> frames;
+    if(resize || !read(static_cast<const char*>(map), size, frames))
+    {
+        memset(map, 0, size);
+        DotRecordingHeader* header = static_cast<DotRecordingHeader*>(map);
+        memcpy(header->magic, magic, sizeof(magic));
+        header->version = DotRecordingHeader::current_version;
+        header->header_size = sizeof(DotRecordingHeader);
+        header->capacity = (size - sizeof(DotRecordingHeader)) & ~7u;
+    }
+    m_path = path;
+    m_size = size;
+    m_map = map;
+    m_header = static_cast<DotRecordingHeader*>(map);
+    m_ring = static_cast<char*>(map) + m_header->header_size;
+    m_since_snapshot = 0;
+    return true;
+}
+
+void DotRecorder::close()
+{
+    if(m_map)
+    {
+        munmap(m_map, m_size);
+        m_map = 0;
+        m_header = 0;
+        m_ring = 0;
+    }
+    m_path.clear();
+    m_size = 0;
+}
+
+void DotRecorder::evict(uint32_t begin, uint32_t end)
+{
+    while(m_header->num_frames > 0 && m_header->first >= begin && m_header->first < end)
+    {
+        DotBinaryFrame frame;
+        memcpy(&frame, m_ring + m_header->first, sizeof(frame));
+        m_header->first = wrap(m_ring, m_header->capacity, m_header->first + frameLength(frame.size));
+        m_header->num_frames--;
+    }
+}
+
+bool DotRecorder::append(const char* frame, size_t size)
+{
+    if(!m_header || size < sizeof(DotBinaryFrame) || size > m_header->capacity)
+    {
+        return false;
+    }
+    DotBinaryFrame head;
+    memcpy(&head, frame, sizeof(head));
+    uint32_t capacity = m_header->capacity;
+    uint32_t length = frameLength(size - sizeof(DotBinaryFrame));
+    uint32_t pos = m_header->next;
+    if(capacity - pos < length)
+    {
+        // Start over at the beginning of the ring
+        evict(pos, capacity);
+        if(capacity - pos >= sizeof(DotBinaryFrame))
+        {
+            DotBinaryFrame padding;
+            memset(&padding, 0, sizeof(padding));
+            padding.type = padding_frame;
+            memcpy(m_ring + pos, &padding, sizeof(padding));
+        }
+        pos = 0;
+    }
+    evict(pos, pos + length);
+    if(m_header->num_frames == 0)
+    {
+        m_header->first = pos;
+    }
+    memcpy(m_ring + pos, frame, size);
+    memset(m_ring + pos + size, 0, length - size);
+
+    // The frame only counts once it is complete
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->next = pos + length;
+    m_header->num_frames++;
+    m_header->sequence++;
+    m_since_snapshot = head.type == DotBinaryFrame::SnapshotFrame ? 0 : m_since_snapshot + length;
+    return true;
+}
+
+bool DotRecorder::read(const char* data, size_t size, std::vector<Frame>& frames)
+{
+    frames.clear();
+    DotRecordingHeader header;
+    if(size < sizeof(header))
+    {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if(memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != DotRecordingHeader::current_version
+       || header.header_size < sizeof(header) || header.header_size % 8 != 0 || header.header_size > size
+       || header.capacity > size - header.header_size || header.capacity % 8 != 0
+       || header.first > header.capacity || header.next > header.capacity || header.first % 8 != 0)
+    {
+        return false;
+    }
+    const char* ring = data + header.header_size;
+    uint32_t offset = header.num_frames > 0 ? wrap(ring, header.capacity, header.first) : 0;
+    for(uint32_t i = 0; i < header.num_frames; i++)
+    {
+        DotBinaryFrame frame;
+        if(header.capacity - offset < sizeof(frame))
+        {
+            return false;
+        }
+        memcpy(&frame, ring + offset, sizeof(frame));
+        if((frame.type != DotBinaryFrame::SnapshotFrame && frame.type != DotBinaryFrame::DeltaFrame)
+           || frame.size > header.capacity - offset - sizeof(frame))
+        {
+            return false;
+        }
+        Frame f;
+        f.type = frame.type;
+        f.timestamp = frame.timestamp;
+        f.data = ring + offset + sizeof(frame);
+        f.size = frame.size;
+        frames.push_back(f);
+        offset = wrap(ring, header.capacity, offset + frameLength(frame.size));
+    }
+    return true;
+}
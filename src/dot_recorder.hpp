@@ -0,0 +1,138 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Fixed-size memory-mapped ring of snapshot frames for post-mortem analysis
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_RECORDER_HPP
+#define DOT_RECORDER_HPP
+
+#include "dot_binary.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** \brief Header of a recording
+ *
+ *  Followed by a ring of capacity bytes holding DotBinaryFrames, each padded to a multiple of 8 bytes.
+ *  The num_frames frames starting at offset first are valid, oldest first; next is where the next frame goes.
+ *  A frame that does not fit before the end of the ring starts over at offset 0. The rest of the ring is then skipped, marked by a frame of type 0 if there is room for one.
+ */
+struct DotRecordingHeader
+{
+    static const uint32_t current_version = 1;
+
+    /// "RTTDOTR" and a terminating zero
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t capacity;
+    uint32_t first;
+    uint32_t next;
+    uint32_t num_frames;
+    /// Number of frames appended since the recording was created
+    uint64_t sequence;
+};
+
+/** \brief Records snapshot frames in a file of fixed size, overwriting the oldest ones
+ *
+ *  The file is mapped into memory, so append() only copies the frame into the mapping: it neither allocates nor calls into the kernel, and takes time proportional to the size of the frame.
+ *  The mapping is populated and locked into memory when it is opened, where permitted, so that appending does not wait for the disk either.
+ *  A frame only becomes part of the recording once it is completely written, so the file is valid whenever the process stops, including on a crash.
+ *  An existing recording of the same size is continued instead of being overwritten.
+ */
+class DotRecorder {
+  public:
+    /// Frame found in a recording by read()
+    struct Frame
+    {
+        uint32_t type;
+        uint64_t timestamp;
+        /// Payload of the frame
+        const char* data;
+        uint32_t size;
+    };
+
+    DotRecorder();
+    ~DotRecorder();
+
+    /** \brief Map the recording at path
+     *
+     *  Closes the recording currently open, if any. An empty path only closes it.
+     *  @param size size of the file in bytes, including the header
+     *  @return false if the file could not be mapped
+     */
+    bool open(const std::string& path, size_t size);
+    void close();
+    /// Path of the open recording, empty if closed
+    const std::string& path() const { return m_path; }
+    /// Size the recording was opened with
+    size_t size() const { return m_size; }
+    /// Number of bytes available for frames
+    size_t capacity() const { return m_header ? m_header->capacity : 0; }
+
+    /** \brief Append a frame made with DotBinaryEmitter::beginFrame() and endFrame()
+     *
+     *  Overwrites as many of the oldest frames as needed.
+     *  @return false if no recording is open or the frame is larger than the ring
+     */
+    bool append(const char* frame, size_t size);
+    /// Number of bytes appended since the last SnapshotFrame, or since the recording was opened
+    size_t sinceSnapshot() const { return m_since_snapshot; }
+
+    /** \brief Read the frames of a recording, oldest first
+     *
+     *  @param data the recording, starting with its header and aligned to 8 bytes
+     *  @param size number of bytes available at data
+     *  @param frames cleared and filled with the frames, which point into data
+     *  @return false if data does not hold a valid recording
+     */
+    static bool read(const char* data, size_t size, std::vector<Frame>& frames);
+
+  private:
+    static uint32_t frameLength(uint32_t size);
+    /// Offset of the frame stored at offset, or 0 if the ring starts over there
+    static uint32_t wrap(const char* ring, uint32_t capacity, uint32_t offset);
+    /// Drop the oldest frames as long as they start in [begin, end)
+    void evict(uint32_t begin, uint32_t end);
+
+    std::string m_path;
+    size_t m_size;
+    void* m_map;
+    DotRecordingHeader* m_header;
+    char* m_ring;
+    size_t m_since_snapshot;
+};
+#endif
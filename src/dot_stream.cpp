@@ -0,0 +1,369 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_stream.hpp"
+#include <rtt/Logger.hpp>
+#include <rtt/os/MutexLock.hpp>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace RTT;
+
+namespace {
+bool setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+}
+
+DotStream::DotStream()
+    : m_listen(-1)
+    ,m_sequence(0)
+    ,m_max_lag(0)
+    ,m_stop(false)
+{
+    m_wake[0] = m_wake[1] = -1;
+}
+
+DotStream::~DotStream()
+{
+    close();
+}
+
+bool DotStream::open(const std::string& path, int priority, unsigned int cpu_affinity)
+{
+    if(path == m_path)
+    {
+        return true;
+    }
+    close();
+    if(path.empty())
+    {
+        return true;
+    }
+
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(addr.sun_path))
+    {
+        log(Error) << "Stream socket path too long: " << path << endlog();
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    m_listen = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(m_listen == -1 || !setNonBlocking(m_listen) || pipe(m_wake) == -1)
+    {
+        log(Error) << "Unable to create stream socket: " << std::strerror(errno) << endlog();
+        close();
+        return false;
+    }
+    setNonBlocking(m_wake[0]);
+    setNonBlocking(m_wake[1]);
+    // A socket left behind by an earlier deployment would make bind() fail
+    if(!removeSocket(path))
+    {
+        log(Error) << "Not replacing " << path << " by the stream socket, it is not a socket" << endlog();
+        close();
+        return false;
+    }
+    if(bind(m_listen, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 || listen(m_listen, 8) == -1)
+    {
+        log(Error) << "Unable to listen on stream socket " << path << ": " << std::strerror(errno) << endlog();
+        close();
+        return false;
+    }
+    m_path = path;
+
+    {
+        os::MutexLock lock(m_lock);
+        m_latest.reset();
+        m_sequence = 0;
+        m_stop = false;
+    }
+    m_activity.reset(new Activity(ORO_SCHED_OTHER, priority, 0.0, cpu_affinity, this, "DotStream"));
+    if(!m_activity->start())
+    {
+        log(Error) << "Unable to start the dot stream thread" << endlog();
+        close();
+        return false;
+    }
+    log(Info) << "Streaming snapshots on " << path << endlog();
+    return true;
+}
+
+void DotStream::close()
+{
+    if(m_activity)
+    {
+        m_activity->stop();
+        m_activity.reset();
+    }
+    for(unsigned int i = 0; i < m_clients.size(); i++)
+    {
+        ::close(m_clients[i].fd);
+    }
+    m_clients.clear();
+    if(m_listen != -1)
+    {
+        ::close(m_listen);
+        m_listen = -1;
+    }
+    for(unsigned int i = 0; i < 2; i++)
+    {
+        if(m_wake[i] != -1)
+        {
+            ::close(m_wake[i]);
+            m_wake[i] = -1;
+        }
+    }
+    if(!m_path.empty())
+    {
+        removeSocket(m_path);
+        m_path.clear();
+    }
+}
+
+bool DotStream::removeSocket(const std::string& path)
+{
+    struct stat st;
+    if(lstat(path.c_str(), &st) == -1)
+    {
+        return errno == ENOENT;
+    }
+    return S_ISSOCK(st.st_mode) && (unlink(path.c_str()) == 0 || errno == ENOENT);
+}
+
+void DotStream::publish(const char* data, size_t size, unsigned int max_lag)
+{
+    if(m_path.empty())
+    {
+        return;
+    }
+    // Subscribers only drop references to buffers, so a buffer nobody else refers to stays free
+    std::shared_ptr<std::string> buffer;
+    for(unsigned int i = 0; i < m_buffers.size() && !buffer; i++)
+    {
+        if(m_buffers[i].use_count() == 1)
+        {
+            buffer = m_buffers[i];
+        }
+    }
+    if(!buffer)
+    {
+        buffer = std::make_shared<std::string>();
+        m_buffers.push_back(buffer);
+    }
+    buffer->assign(data, size);
+    {
+        os::MutexLock lock(m_lock);
+        m_latest = buffer;
+        m_sequence++;
+        m_max_lag = max_lag;
+    }
+    wake();
+}
+
+void DotStream::wake()
+{
+    char c = 0;
+    // A full pipe already wakes up the stream thread
+    ssize_t ret = write(m_wake[1], &c, 1);
+    (void)ret;
+}
+
+bool DotStream::breakLoop()
+{
+    {
+        os::MutexLock lock(m_lock);
+        m_stop = true;
+    }
+    wake();
+    return true;
+}
+
+void DotStream::loop()
+{
+    while(true)
+    {
+        // Wake-up pipe, listening socket, then one entry per client
+        m_fds.resize(2 + m_clients.size());
+        m_fds[0].fd = m_wake[0];
+        m_fds[0].events = POLLIN;
+        m_fds[1].fd = m_listen;
+        m_fds[1].events = POLLIN;
+        for(unsigned int i = 0; i < m_clients.size(); i++)
+        {
+            m_fds[2 + i].fd = m_clients[i].fd;
+            m_fds[2 + i].events = pending(m_clients[i]) ? POLLIN | POLLOUT : POLLIN;
+        }
+        for(unsigned int i = 0; i < m_fds.size(); i++)
+        {
+            m_fds[i].revents = 0;
+        }
+        if(poll(&m_fds[0], m_fds.size(), -1) == -1 && errno != EINTR)
+        {
+            log(Error) << "Polling the stream socket failed: " << std::strerror(errno) << endlog();
+            return;
+        }
+
+        if(m_fds[0].revents & POLLIN)
+        {
+            char buf[64];
+            while(read(m_wake[0], buf, sizeof(buf)) > 0) {}
+        }
+        uint64_t sequence;
+        unsigned int max_lag;
+        {
+            os::MutexLock lock(m_lock);
+            if(m_stop)
+            {
+                return;
+            }
+            sequence = m_sequence;
+            max_lag = m_max_lag;
+        }
+        // Walk backwards, so that dropping a client does not shift the ones still to visit
+        for(unsigned int i = m_fds.size() - 2; i-- > 0;)
+        {
+            Client& client = m_clients[i];
+            short revents = m_fds[2 + i].revents;
+            if(revents & (POLLERR | POLLHUP | POLLNVAL))
+            {
+                drop(i, "disconnected");
+                continue;
+            }
+            if(revents & POLLIN)
+            {
+                // Subscribers have nothing to say, only notice them leaving
+                char buf[256];
+                ssize_t ret = recv(client.fd, buf, sizeof(buf), 0);
+                if(ret == 0 || (ret == -1 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                {
+                    drop(i, "disconnected");
+                    continue;
+                }
+            }
+            if(pending(client) && sequence - client.sequence > max_lag)
+            {
+                drop(i, "too slow");
+                continue;
+            }
+            if(!send(client))
+            {
+                drop(i, "disconnected");
+            }
+        }
+        // New subscribers start with the newest frame right away
+        unsigned int first = m_clients.size();
+        if(m_fds[1].revents & POLLIN)
+        {
+            accept();
+        }
+        for(unsigned int i = first; i < m_clients.size(); i++)
+        {
+            if(!send(m_clients[i]))
+            {
+                drop(i--, "disconnected");
+            }
+        }
+    }
+}
+
+void DotStream::accept()
+{
+    while(true)
+    {
+        int fd = ::accept(m_listen, 0, 0);
+        if(fd == -1)
+        {
+            if(errno == EINTR)
+                continue;
+            return;
+        }
+        if(!setNonBlocking(fd))
+        {
+            ::close(fd);
+            continue;
+        }
+        m_clients.push_back(Client());
+        Client& client = m_clients.back();
+        client.fd = fd;
+        client.sent = 0;
+        client.sequence = 0;
+        log(Debug) << "Stream subscriber connected" << endlog();
+    }
+}
+
+bool DotStream::send(Client& client)
+{
+    while(true)
+    {
+        if(!pending(client))
+        {
+            // Continue with the newest frame, skipping the ones published in between
+            os::MutexLock lock(m_lock);
+            if(client.sequence == m_sequence)
+            {
+                return true;
+            }
+            client.frame = m_latest;
+            client.sequence = m_sequence;
+            client.sent = 0;
+        }
+        ssize_t ret = ::send(client.fd, client.frame->data() + client.sent, client.frame->size() - client.sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if(ret == -1)
+        {
+            if(errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.sent += ret;
+    }
+}
+
+void DotStream::drop(unsigned int i, const char* reason)
+{
+    log(Info) << "Dropping stream subscriber: " << reason << endlog();
+    ::close(m_clients[i].fd);
+    m_clients.erase(m_clients.begin() + i);
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Publishes snapshot frames to subscribers on a Unix domain socket
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_STREAM_HPP
+#define DOT_STREAM_HPP
+
+#include <rtt/Activity.hpp>
+#include <rtt/base/RunnableInterface.hpp>
+#include <rtt/os/Mutex.hpp>
+#include <memory>
+#include <poll.h>
+#include <sys/types.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/** \brief Serves the newest frame to every subscriber of a Unix domain socket
+ *
+ *  The socket is served by its own thread, blocking in poll(), so neither accepting nor sending ever blocks the thread calling publish().
+ *  A subscriber receives the newest frame as soon as it connects, and every later frame it can keep up with: a subscriber first completes the frame it is receiving, then continues with the newest one, skipping the frames published in between.
+ *  A subscriber that is still receiving the same frame after max_lag newer ones were published is disconnected.
+ *  Frames are immutable buffers shared by all subscribers, so the lock shared with publish() only guards the exchange of the newest one and is never held while copying or sending a frame.
+ */
+class DotStream : public RTT::base::RunnableInterface {
+  public:
+    DotStream();
+    ~DotStream();
+
+    /** \brief Listen on the socket at path
+     *
+     *  Closes the socket currently listened on, if any. An empty path only closes it.
+     *  A socket left at path, e.g. by an earlier deployment, is replaced; any other file there is left alone.
+     *  @return false if the socket could not be opened
+     */
+    bool open(const std::string& path, int priority, unsigned int cpu_affinity);
+    /// Disconnect all subscribers and remove the socket
+    void close();
+    /// Path of the socket listened on, empty if closed
+    const std::string& path() const { return m_path; }
+
+    /// Hand a frame to the subscribers; it is copied into a frame buffer that is free again, allocating one only if all are in use
+    void publish(const char* data, size_t size, unsigned int max_lag);
+
+    bool initialize() { return true; }
+    void step() {}
+    void loop();
+    bool breakLoop();
+    void finalize() {}
+  private:
+    typedef std::shared_ptr<const std::string> Frame;
+
+    struct Client
+    {
+        int fd;
+        /// Frame being sent, 0 if none was yet, and the number of bytes of it sent so far
+        Frame frame;
+        size_t sent;
+        /// Sequence number of frame, 0 if nothing was sent yet
+        uint64_t sequence;
+    };
+
+    int m_listen;
+    /// Pipe that wakes up the stream thread
+    int m_wake[2];
+    std::string m_path;
+    std::unique_ptr<RTT::Activity> m_activity;
+
+    /// Frame buffers filled by publish(); a buffer is free again once only this list refers to it
+    std::vector<std::shared_ptr<std::string> > m_buffers;
+
+    // Shared with the stream thread, guarded by m_lock
+    RTT::os::Mutex m_lock;
+    Frame m_latest;
+    uint64_t m_sequence;
+    unsigned int m_max_lag;
+    bool m_stop;
+
+    // Only used by the stream thread
+    std::vector<Client> m_clients;
+    std::vector<pollfd> m_fds;
+    static bool pending(const Client& client) { return client.frame && client.sent < client.frame->size(); }
+    /// Remove the socket at path, false if something else than a socket is there
+    static bool removeSocket(const std::string& path);
+    void wake();
+    void accept();
+    bool send(Client& client);
+    void drop(unsigned int i, const char* reason);
+};
+#endif
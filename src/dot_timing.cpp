@@ -0,0 +1,168 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_timing.hpp"
+#include <rtt/ExecutionEngine.hpp>
+#include <time.h>
+
+namespace {
+inline int64_t now(clockid_t clock)
+{
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+}
+
+DotStepSampler::DotStepSampler()
+    : m_window(1000000000)
+    ,m_in_engine(false)
+    ,m_retired(false)
+    ,m_started(false)
+    ,m_last_cpu(0)
+    ,m_window_start(0)
+    ,m_steps(0)
+    ,m_busy(0)
+    ,m_max(0)
+    ,m_sequence(0)
+    ,m_out_steps(0)
+    ,m_out_busy(0)
+    ,m_out_max(0)
+    ,m_out_length(0)
+{
+}
+
+bool DotStepSampler::load(RTT::ExecutionEngine* ee)
+{
+    // Set before the engine can unload it again
+    m_in_engine.store(true);
+    if(!ee->runFunction(this))
+    {
+        m_in_engine.store(false);
+        return false;
+    }
+    return true;
+}
+
+void DotStepSampler::unloaded()
+{
+    RTT::base::ExecutableInterface::unloaded();
+    m_in_engine.store(false);
+}
+
+void DotStepSampler::loaded(RTT::ExecutionEngine* ee)
+{
+    RTT::base::ExecutableInterface::loaded(ee);
+    // The thread may have changed while the sampler was not loaded
+    m_started = false;
+}
+
+void DotStepSampler::setWindow(double seconds)
+{
+    m_window.store(int64_t(seconds * 1e9), std::memory_order_relaxed);
+}
+
+bool DotStepSampler::execute()
+{
+    // Returning false has the engine unload the sampler
+    if(m_retired.load())
+    {
+        return false;
+    }
+    int64_t cpu = now(CLOCK_THREAD_CPUTIME_ID);
+    int64_t wall = now(CLOCK_MONOTONIC);
+    int64_t busy = cpu - m_last_cpu;
+    m_last_cpu = cpu;
+    if(!m_started || busy < 0)
+    {
+        m_started = true;
+        m_window_start = wall;
+        m_steps = 0;
+        m_busy = m_max = 0;
+        return true;
+    }
+    m_steps++;
+    m_busy += busy;
+    if(busy > m_max)
+    {
+        m_max = busy;
+    }
+
+    int64_t length = wall - m_window_start;
+    if(length < m_window.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+    uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_out_steps.store(m_steps, std::memory_order_relaxed);
+    m_out_busy.store(m_busy, std::memory_order_relaxed);
+    m_out_max.store(m_max, std::memory_order_relaxed);
+    m_out_length.store(length, std::memory_order_relaxed);
+    m_sequence.store(sequence + 2, std::memory_order_release);
+
+    m_window_start = wall;
+    m_steps = 0;
+    m_busy = m_max = 0;
+    return true;
+}
+
+bool DotStepSampler::read(DotGraph::Timing& timing) const
+{
+    uint32_t steps;
+    int64_t busy, max, length;
+    uint32_t sequence;
+    do
+    {
+        sequence = m_sequence.load(std::memory_order_acquire);
+        steps = m_out_steps.load(std::memory_order_relaxed);
+        busy = m_out_busy.load(std::memory_order_relaxed);
+        max = m_out_max.load(std::memory_order_relaxed);
+        length = m_out_length.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while((sequence & 1) != 0 || sequence != m_sequence.load(std::memory_order_relaxed));
+
+    if(steps == 0 || length <= 0)
+    {
+        timing.steps = 0;
+        timing.mean_us = timing.max_us = timing.load = 0;
+        return false;
+    }
+    timing.steps = steps;
+    timing.mean_us = busy / 1e3 / steps;
+    timing.max_us = max / 1e3;
+    timing.load = double(busy) / length;
+    return true;
+}
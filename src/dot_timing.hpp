@@ -0,0 +1,96 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Step timing of the components of the OROCOS dot service
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_TIMING_HPP
+#define DOT_TIMING_HPP
+
+#include <rtt/base/ExecutableInterface.hpp>
+#include <atomic>
+#include <stdint.h>
+#include "dot_graph.hpp"
+
+/** \brief Measures the CPU time a component's thread spends per step of its ExecutionEngine
+ *
+ *  Run as a function of the component's engine, so execute() is called at the start of every step, before the update hook. The CPU time the thread consumed since the previous step is the cost of that step; for components sharing a thread it covers all of them.
+ *  A step costs two clock readings. The statistics of every complete window are published without locks, so reading them never blocks the component.
+ */
+class DotStepSampler : public RTT::base::ExecutableInterface {
+  public:
+    DotStepSampler();
+
+    /** Hand the sampler to the engine, which starts running it at its next step
+     *  @return false if the engine does not run functions
+     */
+    bool load(RTT::ExecutionEngine* ee);
+    /// The engine runs the sampler, or will at its next step
+    bool inEngine() const { return m_in_engine.load(); }
+    /// Have the engine unload the sampler at its next step, without waiting for it; it can be deleted once it is no longer inEngine()
+    void retire() { m_retired.store(true); }
+
+    void loaded(RTT::ExecutionEngine* ee);
+    void unloaded();
+    bool execute();
+
+    /// Length of the measurement window in seconds
+    void setWindow(double seconds);
+
+    /** Copy the statistics of the last complete window into the measured fields of timing
+     *  @return false if no window was completed yet
+     */
+    bool read(DotGraph::Timing& timing) const;
+
+  private:
+    std::atomic<int64_t> m_window;
+    std::atomic<bool> m_in_engine;
+    std::atomic<bool> m_retired;
+
+    // Only touched by execute() in the component's thread
+    bool m_started;
+    int64_t m_last_cpu;
+    int64_t m_window_start;
+    uint32_t m_steps;
+    int64_t m_busy;
+    int64_t m_max;
+
+    // Last complete window, guarded by m_sequence which is odd while it is written
+    std::atomic<uint32_t> m_sequence;
+    std::atomic<uint32_t> m_out_steps;
+    std::atomic<int64_t> m_out_busy;
+    std::atomic<int64_t> m_out_max;
+    std::atomic<int64_t> m_out_length;
+};
+#endif
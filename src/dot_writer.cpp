@@ -0,0 +1,193 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+
+#include "dot_writer.hpp"
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+DotWriter& DotWriter::unsignedValue(unsigned long long v)
+{
+    char digits[24];
+    char* p = digits + sizeof(digits);
+    do
+    {
+        *--p = char('0' + v % 10);
+        v /= 10;
+    } while(v != 0);
+    m_buffer.append(p, digits + sizeof(digits) - p);
+    return *this;
+}
+
+DotWriter& DotWriter::operator<<(long long v)
+{
+    if(v < 0)
+    {
+        m_buffer.push_back('-');
+        // negate in unsigned arithmetic, also valid for the most negative value
+        return unsignedValue(0ULL - (unsigned long long)v);
+    }
+    return unsignedValue(v);
+}
+
+DotWriter& DotWriter::operator<<(int v)
+{
+    return *this << (long long)v;
+}
+
+DotWriter& DotWriter::operator<<(long v)
+{
+    return *this << (long long)v;
+}
+
+DotWriter& DotWriter::operator<<(double v)
+{
+    char digits[32];
+    int len = snprintf(digits, sizeof(digits), "%g", v);
+    if(len > 0)
+    {
+        m_buffer.append(digits, len < int(sizeof(digits)) ? len : sizeof(digits) - 1);
+    }
+    return *this;
+}
+
+DotWriter& DotWriter::quoted(const std::string& s)
+{
+    m_buffer.push_back('"');
+    for(std::string::const_iterator it = s.begin(); it != s.end(); ++it)
+    {
+        if(*it == '"' || *it == '\\')
+        {
+            m_buffer.push_back('\\');
+        }
+        m_buffer.push_back(*it);
+    }
+    m_buffer.push_back('"');
+    return *this;
+}
+
+DotWriter& DotWriter::jsonString(const std::string& s)
+{
+    static const char digits[] = "0123456789abcdef";
+    m_buffer.push_back('"');
+    for(std::string::const_iterator it = s.begin(); it != s.end(); ++it)
+    {
+        unsigned char c = *it;
+        if(c == '"' || c == '\\')
+        {
+            m_buffer.push_back('\\');
+            m_buffer.push_back(c);
+        }
+        else if(c < 0x20)
+        {
+            char escape[6] = { '\\', 'u', '0', '0', digits[c >> 4], digits[c & 15] };
+            m_buffer.append(escape, sizeof(escape));
+        }
+        else
+        {
+            m_buffer.push_back(c);
+        }
+    }
+    m_buffer.push_back('"');
+    return *this;
+}
+
+DotWriter& DotWriter::jsonNumber(double v)
+{
+    if(!std::isfinite(v))
+    {
+        m_buffer.append("null");
+        return *this;
+    }
+    return *this << v;
+}
+
+DotWriter& DotWriter::hex(unsigned long long v)
+{
+    static const char digits[] = "0123456789abcdef";
+    char out[16];
+    for(int i = 15; i >= 0; i--)
+    {
+        out[i] = digits[v & 15];
+        v >>= 4;
+    }
+    m_buffer.append(out, sizeof(out));
+    return *this;
+}
+
+bool DotWriter::writeFile(const std::string& path)
+{
+    m_tmp_path.assign(path);
+    m_tmp_path.append(".tmp");
+    int fd = ::open(m_tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        return false;
+    }
+    if(!writeTo(fd))
+    {
+        ::close(fd);
+        ::unlink(m_tmp_path.c_str());
+        return false;
+    }
+    if(::close(fd) != 0)
+    {
+        ::unlink(m_tmp_path.c_str());
+        return false;
+    }
+    return ::rename(m_tmp_path.c_str(), path.c_str()) == 0;
+}
+
+bool DotWriter::writeTo(int fd) const
+{
+    const char* p = m_buffer.data();
+    size_t left = m_buffer.size();
+    while(left > 0)
+    {
+        ssize_t n = ::write(fd, p, left);
+        if(n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(n < 0)
+        {
+            return false;
+        }
+        p += n;
+        left -= n;
+    }
+    return true;
+}
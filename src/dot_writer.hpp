@@ -0,0 +1,104 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Append-only text buffer used to format the deployment snapshot
+ * @Author: OROCOS dot service contributors
+ */
+#ifndef DOT_WRITER_HPP
+#define DOT_WRITER_HPP
+
+#include <string>
+
+/** \brief Text buffer that keeps its memory across runs
+ *
+ *  Replaces std::stringstream for the formatting of snapshots: strings are appended, and integers and quoted strings are formatted in place, without any temporary strings.
+ *  clear() keeps the capacity, so once the buffer has grown to the size of the output, formatting does not allocate anymore.
+ */
+class DotWriter {
+  public:
+    explicit DotWriter(size_t capacity = 64 * 1024) { m_buffer.reserve(capacity); }
+
+    /// Empty the buffer, keeping its capacity
+    void clear() { m_buffer.clear(); }
+
+    const std::string& str() const { return m_buffer; }
+    const char* data() const { return m_buffer.data(); }
+    size_t size() const { return m_buffer.size(); }
+    size_t capacity() const { return m_buffer.capacity(); }
+
+    DotWriter& operator<<(const char* s) { m_buffer.append(s); return *this; }
+    DotWriter& operator<<(const std::string& s) { m_buffer.append(s); return *this; }
+    DotWriter& operator<<(char c) { m_buffer.push_back(c); return *this; }
+    DotWriter& operator<<(int v);
+    DotWriter& operator<<(unsigned int v) { return unsignedValue(v); }
+    DotWriter& operator<<(long v);
+    DotWriter& operator<<(unsigned long v) { return unsignedValue(v); }
+    DotWriter& operator<<(long long v);
+    DotWriter& operator<<(unsigned long long v) { return unsignedValue(v); }
+    DotWriter& operator<<(double v);
+
+    /// Append raw bytes
+    DotWriter& append(const void* data, size_t len) { m_buffer.append(static_cast<const char*>(data), len); return *this; }
+
+    /// Replace bytes that were already appended, starting at pos
+    void overwrite(size_t pos, const void* data, size_t len) { m_buffer.replace(pos, len, static_cast<const char*>(data), len); }
+
+    /// Append s between double quotes, escaping quotes and backslashes
+    DotWriter& quoted(const std::string& s);
+
+    /// Append s as a JSON string literal
+    DotWriter& jsonString(const std::string& s);
+
+    /// Append v as a JSON number, or null if it is infinite or not a number, which JSON cannot represent
+    DotWriter& jsonNumber(double v);
+
+    /// Append v as 16 hexadecimal digits
+    DotWriter& hex(unsigned long long v);
+
+    /** \brief Write the buffer to a file
+     *
+     *  The buffer is written to a temporary file next to path which then replaces path, so readers never see a partially written file.
+     */
+    bool writeFile(const std::string& path);
+
+    /// Write the buffer to the file open at fd, e.g. a log opened with O_APPEND
+    bool writeTo(int fd) const;
+
+  private:
+    DotWriter& unsignedValue(unsigned long long v);
+
+    std::string m_buffer;
+    std::string m_tmp_path;
+};
+#endif
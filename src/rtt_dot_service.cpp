@@ -36,342 +36,1462 @@
 *******************************************************************************/
 
 #include "rtt_dot_service.hpp"
-#include <fstream>
 #include <rtt/rtt-config.h>
-#include <sstream>
+#include <rtt/os/TimeService.hpp>
+#include <rtt/os/ThreadInterface.hpp>
+#include <rtt/OperationInterfacePart.hpp>
+#include <rtt/base/OperationCallerBaseInvoker.hpp>
+#include <rtt/base/OperationCallerInterface.hpp>
+#include <rtt/extras/FileDescriptorActivity.hpp>
+#include <rtt/extras/SequentialActivity.hpp>
+#include <rtt/extras/SlaveActivity.hpp>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace RTT;
 
+namespace {
+// FNV-1a, used to fingerprint the deployment cheaply
+const uint64_t fnv_offset = 14695981039346656037ULL;
+const uint64_t fnv_prime = 1099511628211ULL;
+
+inline void hashBytes(uint64_t& h, const void* data, size_t len)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for(size_t i = 0; i < len; ++i)
+    {
+        h ^= p[i];
+        h *= fnv_prime;
+    }
+}
+
+inline void hashString(uint64_t& h, const std::string& s)
+{
+    hashBytes(h, s.data(), s.size());
+    // terminate so that "ab"+"c" and "a"+"bc" differ
+    hashBytes(h, "", 1);
+}
+
+template<class T>
+inline void hashValue(uint64_t& h, const T& v)
+{
+    hashBytes(h, &v, sizeof(v));
+}
+
+/** Thread an operation was defined to run in
+ *  OperationCallerInterface::isSend() also depends on the thread asking, which would make the drawing depend on scan_threads.
+ */
+struct OperationThread : public base::OperationCallerInterface
+{
+    static ExecutionThread of(const base::OperationCallerInterface& op) { return op.*(&OperationThread::met); }
+};
+
+// Names of the kinds of activities, in the order of Dot::m_activity_kinds
+const char* const activity_kinds[6] = { "none", "Activity", "SlaveActivity", "SequentialActivity", "FileDescriptorActivity", "other" };
+}
+
 Dot::Dot(TaskContext* owner)
     : Service("dot", owner), base::ExecutableInterface()
     ,m_dot_file("orograph.dot")
     ,m_comp_args("style=\"rounded,filled\",fontsize=15,color=\"#777777\",fillcolor=\"#eeeeee\",")
     ,m_conn_args(" ")
     ,m_chan_args("shape=record,")
+    ,m_formats("dot")
+    ,m_json_file("orograph.json")
+    ,m_binary_file("orograph.bin")
+    ,m_delta_file("orograph.delta")
+    ,m_record_file("orograph.rec")
+    ,m_record_size(16 * 1024 * 1024)
+    ,m_layout_file("orograph.xdot")
+    ,m_layout_command("dot -Txdot")
+    ,m_layout_cache_dir("")
+    ,m_async(false)
+    ,m_worker_priority(0)
+    ,m_worker_cpu_affinity(~0u)
+    ,m_stream_max_lag(4)
+    ,m_trigger_mode("update")
+    ,m_min_period(1.0)
+    ,m_debounce(0.5)
+    ,m_recursive(false)
+    ,m_scan_threads(0)
+    ,m_scan_priority(0)
+    ,m_scan_cpu_affinity(~0u)
+    ,m_cluster_by("none")
+    ,m_cluster_separators("_.")
+    ,m_collapse_clusters(false)
+    ,m_bundle_fanout(0)
+    ,m_timing(false)
+    ,m_channel_stats(false)
+    ,m_operations(false)
+    ,m_timing_window(1.0)
+    ,m_skip_count(0)
+    ,m_generate_count(0)
+    ,m_coalesce_count(0)
+    ,m_num_scans(0)
+    ,m_scan_job(this)
+    ,m_structure(0)
+    ,m_state(0)
+    ,m_cluster_mode(NoClusters)
+    ,m_parsed_cluster_by("none")
+    ,m_drop_generation(0)
+    ,m_drop_sampled(0)
+    ,m_free_input(0)
+    ,m_free_output(0)
+    ,m_has_fingerprint(false)
+    ,m_structure_hash(0)
+    ,m_state_hash(0)
+    ,m_mode(EveryUpdate)
+    ,m_parsed_trigger_mode("update")
+    ,m_last_update(0)
+    ,m_pending(false)
+    ,m_pending_since(0)
+    ,m_last_change(0)
+    ,m_pending_structure(0)
+    ,m_pending_state(0)
+    ,m_layout_rejected(false)
+    ,m_delta_fd(-1)
+    ,m_has_previous(false)
+    ,m_has_recorded(false)
+    ,m_runner(this)
+    ,m_applied_priority(0)
+    ,m_applied_cpu_affinity(~0u)
+    ,m_write_failed(false)
 {
+    m_backends[DotFormat] = &m_dot_emitter;
+    m_backends[JsonFormat] = &m_json_emitter;
+    m_backends[BinaryFormat] = &m_binary_emitter;
+    // Deltas are appended by writeDelta(), layouts written by m_layout, recordings by record()
+    m_backends[DeltaFormat] = 0;
+    m_backends[LayoutFormat] = 0;
+    m_backends[RecordFormat] = 0;
+    m_selected[DotFormat] = true;
+    m_selected[JsonFormat] = false;
+    m_selected[BinaryFormat] = false;
+    m_selected[DeltaFormat] = false;
+    m_selected[LayoutFormat] = false;
+    m_selected[RecordFormat] = false;
+    m_parsed_formats = m_formats;
+
+    m_free_input = m_current.graph.intern("free input ports");
+    m_free_output = m_current.graph.intern("free output ports");
+    for(unsigned int i = 0; i < 6; i++)
+    {
+        m_activity_kinds[i] = m_current.graph.intern(activity_kinds[i]);
+    }
+
     this->addOperation("getOwnerName", &Dot::getOwnerName, this).doc("Returns the name of the owner of this object.");
-    this->addOperation("generate", &Dot::execute, this).doc("Generate component overview and write to 'dot_file'.");
+    this->addOperation("generate", &Dot::generate, this).doc("Generate component overview and write to 'dot_file', even if nothing changed.");
     this->addProperty("dot_file", m_dot_file).doc("File to write the generated dot syntax to.");
     this->addProperty("comp_args", m_comp_args).doc("Arguments to add to the component drawings.");
     this->addProperty("conn_args", m_conn_args).doc("Arguments to add to the connection drawings.");
     this->addProperty("chan_args", m_chan_args).doc("Arguments to add to the channel drawings.");
+    this->addProperty("formats", m_formats).doc("Comma separated list of the output formats to write: 'dot' to 'dot_file', 'json' to 'json_file', 'binary' to 'binary_file', 'delta' to 'delta_file', 'layout' to 'layout_file' and 'record' to 'record_file'.");
+    this->addProperty("json_file", m_json_file).doc("File to write the JSON description of the deployment to.");
+    this->addProperty("binary_file", m_binary_file).doc("File to write the binary snapshot of the deployment to.");
+    this->addProperty("layout_file", m_layout_file).doc("File to write the graph laid out by 'layout_command' to. The layout is cached per wiring of the deployment, task state changes only recolor it. It shows the wiring and the task states only, without timing and buffer annotations. Only written in async mode, as Graphviz runs in the writing thread.");
+    this->addProperty("layout_command", m_layout_command).doc("Graphviz command laying out the graph, e.g. 'dot -Txdot' or 'dot -Tsvg'. It is called with '-o output input'.");
+    this->addProperty("layout_cache_dir", m_layout_cache_dir).doc("Directory to cache the layouts of 'layout_command' in, empty for $XDG_CACHE_HOME/rtt_dot or ~/.cache/rtt_dot. It is created with mode 0700 and has to be accessible to this user only.");
+    this->addProperty("delta_file", m_delta_file).doc("File to append the changes between successive snapshots to, starting with a full snapshot.");
+    this->addProperty("record_file", m_record_file).doc("Memory-mapped file of fixed size to record the snapshots in, as full snapshots and deltas, for post-mortem analysis with rtt_dot_replay. Recording happens in execute(), also in async mode, without allocating or writing to the disk. An existing recording of the same size is continued.");
+    this->addProperty("record_size", m_record_size).doc("Size in bytes of 'record_file'. Once it is full, the oldest snapshots are overwritten; it should hold several full snapshots.");
+    this->addProperty("async", m_async).doc("Only take a snapshot in execute() and format and write 'dot_file' in a low-priority worker thread.");
+    this->addProperty("worker_priority", m_worker_priority).doc("Priority of the worker thread used in async mode.");
+    this->addProperty("worker_cpu_affinity", m_worker_cpu_affinity).doc("CPU affinity mask of the worker thread used in async mode.");
+    this->addProperty("stream_socket", m_stream_socket).doc("Unix domain socket to stream every generated snapshot on, as frames holding a binary snapshot. Empty to not stream.");
+    this->addProperty("stream_max_lag", m_stream_max_lag).doc("Number of newer snapshots after which a stream subscriber that is still receiving an older one is disconnected.");
+    this->addProperty("trigger_mode", m_trigger_mode).doc("When execute() generates 'dot_file': 'update' on every update in which the deployment changed, 'periodic' at most every 'min_period' seconds, 'on_demand' only through generate(), 'event' once the deployment stopped changing for 'debounce' seconds.");
+    this->addProperty("min_period", m_min_period).doc("Minimal time in seconds between two generations in periodic mode.");
+    this->addProperty("debounce", m_debounce).doc("Time in seconds the deployment has to stay unchanged before a generation in event mode. A deployment that keeps changing is still generated every ten debounce windows.");
+    this->addProperty("recursive", m_recursive).doc("Also draw the peers of peers, e.g. the components of sub-deployers and composite components.");
+    this->addProperty("scan_threads", m_scan_threads).doc("Number of threads helping to scan the peers of large deployments, 0 to scan them in the calling thread only. The output does not depend on it.");
+    this->addProperty("scan_priority", m_scan_priority).doc("Priority of the scan threads. execute() waits for them, so in a real-time Deployer set it to the Deployer's priority; a positive priority runs them with the real-time scheduler.");
+    this->addProperty("scan_cpu_affinity", m_scan_cpu_affinity).doc("CPU affinity mask of the scan threads.");
+    this->addProperty("component_include", m_component_include).doc("Regular expression (POSIX extended) a peer name has to contain to be drawn, empty to draw all peers. Peers that are not drawn are not scanned either, nor are their peers in recursive mode.");
+    this->addProperty("component_exclude", m_component_exclude).doc("Regular expression (POSIX extended) of the peer names not to draw, empty to not exclude any.");
+    this->addProperty("port_include", m_port_include).doc("Regular expression (POSIX extended) a port name has to contain to be drawn, empty to draw all ports. Connections of ports that are not drawn are left out.");
+    this->addProperty("port_exclude", m_port_exclude).doc("Regular expression (POSIX extended) of the port names not to draw, empty to not exclude any.");
+    this->addProperty("cluster_by", m_cluster_by).doc("Group components into clusters: 'none', 'prefix' by their name up to the first of 'cluster_separators', or 'activity' by the thread running them. Clusters of a single component are not drawn.");
+    this->addProperty("cluster_separators", m_cluster_separators).doc("Characters ending the name prefix that components are clustered by in prefix mode.");
+    this->addProperty("collapse_clusters", m_collapse_clusters).doc("Draw every cluster as a single node, with one edge per pair of connected nodes labelled with the number of connections it stands for.");
+    this->addProperty("bundle_fanout", m_bundle_fanout).doc("Draw an output port with at least this many local subscribers of the same policy as a single edge to a hub node labelled with their number and policy, with a plain edge from the hub to every subscriber; 0 to draw every connection.");
+    this->addProperty("timing", m_timing).doc("Annotate every component with its activity, period, priority, CPU affinity and the number of components sharing its thread, and with the CPU time its thread spends per step, measured by a function run in its engine. Measured components are colored by load instead of by state; the file is regenerated when a load changes by 10%.");
+    this->addProperty("channel_stats", m_channel_stats).doc("Sample the fill level and the dropped samples of the buffer of every connection and draw them on the edges: wider with the fill level, orange when nearly full and red while dropping. Only lock-free buffers are sampled, so sampling never takes a lock of the deployment nor races with the users of an unsynchronized buffer; it needs RTT 2.9.");
+    this->addProperty("operations", m_operations).doc("Draw the operations the components call on each other through the OperationCallers of their required services, bound to the peer providing them as TaskContext::connectServices() does. Calls of OwnThread operations are queued to the callee's thread and drawn in red, ClientThread calls in gray. When several peers provide the operation, the call is drawn to the first one and marked as guessed.");
+    this->addProperty("timing_window", m_timing_window).doc("Length in seconds of the window the step costs are averaged over in timing mode, and the drop rates in channel_stats mode.");
+    this->addAttribute("skip_count", m_skip_count);
+    this->addAttribute("generate_count", m_generate_count);
+    this->addAttribute("coalesce_count", m_coalesce_count);
     this->doc("Dot service interface.");
     //owner->engine()->runFunction(this);
 }
 
-std::string Dot::getOwnerName()
+Dot::~Dot()
 {
-    return getOwner()->getName();
+    retireSamplers(true);
+    // An engine that did not step since would run a deleted sampler, leave them to it
+    for(unsigned int i = 0; i < m_retired_samplers.size(); i++)
+    {
+        if(m_retired_samplers[i]->inEngine())
+        {
+            m_retired_samplers[i].release();
+        }
+    }
+    stopWorker();
+    m_stream.close();
+    closeDelta();
+    m_recorder.close();
 }
 
-std::string Dot::quote(std::string const& name)
+std::string Dot::getOwnerName()
 {
-  return "\"" + name + "\"";
+    return getOwner()->getName();
 }
 
-void Dot::scanService(std::string path, Service::shared_ptr sv)
+void Dot::scanService(PeerScan& scan, Service::shared_ptr sv, unsigned int& inputs, unsigned int& outputs)
 {
-    std::vector<std::string> comp_ports;
-    comp_ports.clear();
-    // Get all component ports
-    comp_ports = sv->getPortNames();
+    hashString(scan.structure, sv->getName());
+    unsigned int path = scan.num_paths++;
+    if(path == scan.paths.size())
+    {
+        scan.paths.push_back(scan.path);
+    }
+    else
+    {
+        scan.paths[path] = scan.path;
+    }
+    const Service::Ports& ports = sv->getPorts();
+    for(Service::Ports::const_iterator it = ports.begin(); it != ports.end(); ++it)
+    {
+        base::PortInterface* port = *it;
+        // Filtered ports are skipped before they are numbered, so the fields of the drawn ones stay contiguous
+        if(scan.port_filter && !acceptPort(scan, port))
+        {
+            scan.excluded.push_back(port);
+            continue;
+        }
+        PortEntry entry;
+        entry.port = port;
+        entry.path = path;
+        entry.peer = 0;
+        if(dynamic_cast<base::InputPortInterface*>(port) != 0)
+        {
+            entry.direction = DotGraph::Input;
+            entry.field = inputs++;
+        }
+        else if(dynamic_cast<base::OutputPortInterface*>(port) != 0)
+        {
+            entry.direction = DotGraph::Output;
+            entry.field = outputs++;
+        }
+        else
+        {
+            continue;
+        }
+        hashString(scan.structure, port->getName());
+        hashValue(scan.structure, entry.direction);
+        scan.ports.push_back(entry);
 
-    // Loop over all ports
-    for(unsigned int j = 0; j < comp_ports.size(); j++){
-      log(Debug) << "        Port: " << comp_ports[j] << endlog();
 #if RTT_VERSION_GTE(2,8,99)
-      std::list<internal::ConnectionManager::ChannelDescriptor> chns = sv->getPort(comp_ports[j])->getManager()->getConnections();
+        std::list<internal::ConnectionManager::ChannelDescriptor> chns = port->getManager()->getConnections();
 #else
-      std::list<internal::ConnectionManager::ChannelDescriptor> chns = sv->getPort(comp_ports[j])->getManager()->getChannels();
+        std::list<internal::ConnectionManager::ChannelDescriptor> chns = port->getManager()->getChannels();
 #endif
-      std::list<internal::ConnectionManager::ChannelDescriptor>::iterator k;
-
-      bool is_input_port = (dynamic_cast<base::InputPortInterface*>(sv->getPort(comp_ports[j])) != 0);
-
-      for(k = chns.begin(); k != chns.end(); k++){
-        base::ChannelElementBase::shared_ptr bs = k->get<1>();
-        ConnPolicy cp = k->get<2>();
-
-        // Get input component name
-        std::string comp_in, port_in;
-        if(bs->getInputEndPoint()->getPort() != 0){
-          if (bs->getInputEndPoint()->getPort()->getInterface() != 0 ){
-            comp_in = bs->getInputEndPoint()->getPort()->getInterface()->getOwner()->getName();
-          }
-          else{
-            comp_in = "free input ports";
-          }
-          port_in = bs->getInputEndPoint()->getPort()->getName();
+        hashValue(scan.structure, chns.size());
+        for(std::list<internal::ConnectionManager::ChannelDescriptor>::iterator k = chns.begin(); k != chns.end(); k++)
+        {
+            base::ChannelElementBase::shared_ptr bs = k->get<1>();
+            scan.channels.push_back(ChannelEntry());
+            ChannelEntry& ch = scan.channels.back();
+            ch.port = scan.ports.size() - 1;
+            ch.writer = bs->getInputEndPoint()->getPort();
+            ch.reader = bs->getOutputEndPoint()->getPort();
+            ch.policy = k->get<2>();
+            ch.buffer = 0;
+            ch.stats = DotGraph::ChannelStats();
+            // Only lock-free buffers can be read while their writer and reader use them; locked ones would take their lock, unsynchronized ones race
+            if(scan.channel_stats && ch.policy.lock_policy == ConnPolicy::LOCK_FREE)
+            {
+                sampleBuffer(ch, bs, entry.direction == DotGraph::Input);
+            }
+            // The endpoint ports identify the connection, the policy how it is drawn
+            hashValue(scan.structure, ch.writer);
+            hashValue(scan.structure, ch.reader);
+            hashValue(scan.structure, ch.policy.type);
+            hashValue(scan.structure, ch.policy.size);
+            hashValue(scan.structure, ch.policy.lock_policy);
+            hashValue(scan.structure, ch.policy.transport);
+            hashValue(scan.structure, ch.policy.init);
+            hashValue(scan.structure, ch.policy.pull);
+            hashString(scan.structure, ch.policy.name_id);
         }
+    }
+    // recurse for sub services
+    Service::ProviderNames providers = sv->getProviderNames();
+    for(Service::ProviderNames::iterator it=providers.begin(); it != providers.end(); ++it)
+    {
+        std::string::size_type len = scan.path.size();
+        if(len != 0)
+        {
+            scan.path += '.';
+        }
+        scan.path += *it;
+        scanService(scan, sv->provides(*it), inputs, outputs);
+        scan.path.resize(len);
+    }
+}
 
-        // Get output component name
-        std::string comp_out, port_out;
-        if(bs->getOutputEndPoint()->getPort() != 0){
-          if (bs->getOutputEndPoint()->getPort()->getInterface() != 0 ){
-            comp_out = bs->getOutputEndPoint()->getPort()->getInterface()->getOwner()->getName();
-          }
-          else{
-            comp_out = "free output ports";
-          }
-          port_out = bs->getOutputEndPoint()->getPort()->getName();
+void Dot::sampleBuffer(ChannelEntry& ch, base::ChannelElementBase::shared_ptr element, bool at_input_port)
+{
+#if RTT_VERSION_GTE(2,8,99)
+    // Walk away from the port, so that the walk stays on this connection even if the port multiplexes several
+    for(unsigned int i = 0; element && i < 8; i++)
+    {
+        base::ChannelBufferElementBase* buffer = dynamic_cast<base::ChannelBufferElementBase*>(element.get());
+        if(buffer != 0)
+        {
+            ch.buffer = buffer;
+            ch.stats.capacity = buffer->getBufferSize();
+            ch.stats.fill = buffer->getBufferFillSize();
+            ch.stats.dropped = buffer->getNumDroppedSamples();
+            return;
         }
+        element = at_input_port ? element->getInput() : element->getOutput();
+    }
+#else
+    (void)ch;
+    (void)element;
+    (void)at_input_port;
+#endif
+}
 
-        log(Debug) << "          Connection : [" << comp_in << "] "<<port_in<<" <-> "<< "[" << comp_out << "] " << port_out << endlog();
+unsigned int Dot::callName(PeerScan& scan, const std::string& name)
+{
+    unsigned int index = scan.num_call_names++;
+    if(index == scan.call_names.size())
+    {
+        scan.call_names.push_back(name);
+    }
+    else
+    {
+        scan.call_names[index] = name;
+    }
+    return index;
+}
 
+OperationInterfacePart* Dot::findOperation(TaskContext* peer, const std::string& service, const std::string& operation, bool root)
+{
+    Service::shared_ptr sv = peer->provides();
+    if(!root)
+    {
+        if(!sv->hasService(service))
+        {
+            return 0;
+        }
+        sv = sv->provides(service);
+    }
+    return sv->getPart(operation);
+}
 
-        std::string conn_info;
-        std::stringstream ss;
-        switch(cp.type){
-        case ConnPolicy::DATA:
-            conn_info = "data";
-            break;
-        case ConnPolicy::BUFFER:
-            ss << "buffer [ " << cp.size << " ]";
-            conn_info = ss.str();
-            break;
-        case ConnPolicy::CIRCULAR_BUFFER:
-            ss << "circbuffer [ " << cp.size << " ]";
-            conn_info = ss.str();
-            break;
-        default:
-            conn_info = "unknown";
+bool Dot::findCallee(PeerScan& scan, const std::string& service, const std::string& operation, bool root, CallEntry& call)
+{
+    OperationInterfacePart* part = 0;
+    call.guessed = false;
+    for(unsigned int i = 0; i < scan.peer_names.size(); i++)
+    {
+        TaskContext* peer = scan.tc->getPeer(scan.peer_names[i]);
+        OperationInterfacePart* found = peer ? findOperation(peer, service, operation, root) : 0;
+        if(found == 0)
+        {
+            continue;
         }
-        log(Debug) << "      Connection has conn_info: " << conn_info << endlog();
-        // Only consider input ports
-        if(is_input_port){
-          // First, consider regular connections
-          if(!comp_in.empty()){
-            // If the ConnPolicy has a non-empty name, use that name as the topic name
-            if(!cp.name_id.empty()){
-              // plot the channel element as a seperate box and connect input and output with it
-              m_dot << comp_in <<":"<<comp_ports_map[comp_in][port_in] << " -> " << quote(cp.name_id) << " [color=\"#2a4563\",style=bold];\n";
-            //   m_dot << quote(cp.name_id) << "[" << m_chan_args << "label=" << quote(cp.name_id) << "];\n";
-            //   m_dot << quote(comp_in) << "->" << quote(cp.name_id) << "[" << m_conn_args << "label=" << quote(port_in) << "];\n";
-            //   m_dot << quote(cp.name_id) << "->" << quote(comp_out) << "[" << m_conn_args << "label=" << quote(port_out) << "];\n";
-            }
-            // Else, use a custom name: compInportIncompOutportOut
-            else{
-              // plot the channel element as a seperate box and connect input and output with it
-              m_dot << comp_in <<":"<<comp_ports_map[comp_in][port_in] <<" -> "<< comp_out <<":"<<comp_ports_map[comp_out][port_out]<< " [color=\"#2a4563\",style=bold];\n";
-            //   m_dot << quote(comp_in + port_in + comp_out + port_out) << "[" << m_chan_args << "label=" << quote(conn_info) << "];\n";
-            //   m_dot << quote(comp_in) << "->" << quote(comp_in + port_in + comp_out + port_out) << "[" << m_conn_args << "label=" << quote(port_in) << "];\n";
-            //   m_dot << quote(comp_in + port_in + comp_out + port_out) << "->" << comp_out << "[" << m_conn_args << "label=" << quote(port_out) << "];\n";
-            }
-          }else{
-              m_dot << quote(cp.name_id) <<" -> "<< comp_out <<":"<<comp_ports_map[comp_out][port_out];
-              switch(cp.transport)
-              {
-                  case 1:
-                    m_dot << " [" << m_conn_args << "label=CORBA,style=dashed];";
-                    break;
-                  case 2:
-                    m_dot << " [" << m_conn_args << "label=MQ,style=dashed];";
-                    break;
-                  case 3:
-                    m_dot << " [" << m_conn_args << "label=ROS,style=dashed];";
-                    break;
-                default:
-                    break;
-              }
-              m_dot << "\n";
-            // m_dot << quote(comp_out + port_out) << "[" << m_chan_args << "label=" << quote(conn_info) << "];\n";
-            // m_dot << quote(comp_out + port_out) << "->" << quote(comp_out) << "[" << m_conn_args << "label=" << quote(port_out) << "];\n";
-          }
+        if(part != 0)
+        {
+            // The caller is bound to one of the peers providing the operation, not known which
+            call.guessed = true;
+            break;
         }
-        else{
-          // Consider only output ports that do not have a corresponding input port
-          if(comp_out.empty()){
-            // If the ConnPolicy has a non-empty name, use that name as the topic name
-            if(!cp.name_id.empty())
-            {
-              // plot the channel element as a seperate box and connect input and output with it
-              m_dot << comp_in <<":"<<comp_ports_map[comp_in][port_in] << " -> " << quote(cp.name_id);
-              switch(cp.transport)
-              {
-                  case 1:
-                    m_dot << " [" << m_conn_args << "label=CORBA,style=dashed];";
-                    break;
-                  case 2:
-                    m_dot << " [" << m_conn_args << "label=MQ,style=dashed];";
-                    break;
-                  case 3:
-                    m_dot << " [" << m_conn_args << "label=ROS,style=dashed];";
-                    break;
-                default:
-                    break;
-              }
-              m_dot << "\n";
-            }
-            else
-            {
-              // plot the channel element as a seperate box and connect input and output with it
-              //log(Debug) << "case 22" << std::endlog();
-              //m_dot << comp_in <<":"<<comp_ports_map[comp_in][port_in] << " -> " << quote(cp.name_id);
-              //m_dot << comp_in <<":"<<comp_ports_map[mpeer][point_in] << "[label=" << conn_info << "];\n";
-             // m_dot << comp_in << "->" <<  comp_in + port_in) << "[" << m_conn_args << "label=" << port_in) << "];\n";
-            }
-          }
-          else {
-              log(Debug) << "        Dropped " << conn_info << " from " << comp_out + port_out << " to " << comp_in + port_in << endlog();
-          }
+        part = found;
+        call.callee = peer;
+    }
+    if(part == 0)
+    {
+        return false;
+    }
+    // Only local operations know the thread they run in
+    base::OperationCallerInterface::shared_ptr impl = boost::dynamic_pointer_cast<base::OperationCallerInterface>(part->getLocalOperation());
+    call.remote = !impl;
+    call.own_thread = impl && OperationThread::of(*impl) == OwnThread;
+    return true;
+}
+
+void Dot::scanCalls(PeerScan& scan, ServiceRequester::shared_ptr sr, bool root)
+{
+    std::string service = root ? std::string() : sr->getRequestName();
+    std::vector<std::string> operations = sr->getOperationCallerNames();
+    for(unsigned int i = 0; i < operations.size(); i++)
+    {
+        base::OperationCallerBaseInvoker* caller = sr->getOperationCaller(operations[i]);
+        CallEntry call;
+        if(caller == 0 || !caller->ready() || !findCallee(scan, service, operations[i], root, call))
+        {
+            continue;
         }
+        call.peer = 0;
+        call.service = callName(scan, service);
+        call.operation = callName(scan, operations[i]);
+        hashValue(scan.structure, call.callee);
+        hashString(scan.structure, service);
+        hashString(scan.structure, operations[i]);
+        hashValue(scan.structure, call.own_thread);
+        hashValue(scan.structure, call.guessed);
+        scan.calls.push_back(call);
+    }
+    std::vector<std::string> requesters = sr->getRequesterNames();
+    for(unsigned int i = 0; i < requesters.size(); i++)
+    {
+        scanCalls(scan, sr->requires(requesters[i]), false);
+    }
+}
+
+bool Dot::acceptPort(PeerScan& scan, base::PortInterface* port)
+{
+  const std::string& name = port->getName();
+  unsigned int index = scan.port_verdict_index.find(port);
+  if(index != PortIndex::npos && scan.port_verdicts[index].name == name)
+  {
+    return scan.port_verdicts[index].accepted;
+  }
+  bool accepted = scan.port_filter->accept(name);
+  if(index == PortIndex::npos)
+  {
+    index = scan.port_verdicts.size();
+    scan.port_verdicts.push_back(PortVerdict());
+    scan.port_verdict_index.insert(port, index);
+  }
+  scan.port_verdicts[index].name = name;
+  scan.port_verdicts[index].accepted = accepted;
+  return accepted;
+}
+
+void Dot::scanPeer(PeerScan& scan)
+{
+  scan.state = scan.tc->getTaskState();
+  scan.structure = fnv_offset;
+  scan.num_paths = 0;
+  scan.ports.clear();
+  scan.channels.clear();
+  scan.excluded.clear();
+  scan.path.clear();
+  if(scan.port_filter && scan.port_filter_generation != scan.port_filter->generation())
+  {
+    scan.port_verdict_index.clear();
+    scan.port_verdicts.clear();
+    scan.port_filter_generation = scan.port_filter->generation();
+  }
+  unsigned int inputs = 0, outputs = 0;
+  scanService(scan, scan.tc->provides(), inputs, outputs);
+  // Verdicts of ports that were removed are forgotten once they outnumber the current ports
+  if(scan.port_verdicts.size() > 2 * (scan.ports.size() + scan.excluded.size()) + 64)
+  {
+    scan.port_verdict_index.clear();
+    scan.port_verdicts.clear();
+  }
+  scan.calls.clear();
+  scan.num_call_names = 0;
+  if(scan.operations)
+  {
+    scan.peer_names = scan.tc->getPeerList();
+    scanCalls(scan, scan.tc->requires(), true);
+  }
+}
+
+void Dot::ScanJob::run(unsigned int index)
+{
+  scanPeer(m_dot->m_scans[index]);
+}
+
+Dot::PeerScan& Dot::addPeer(TaskContext* tc, unsigned int name)
+{
+  if(m_num_scans == m_scans.size())
+  {
+    m_scans.push_back(PeerScan());
+  }
+  PeerScan& scan = m_scans[m_num_scans++];
+  if(scan.tc != tc)
+  {
+    scan.port_verdict_index.clear();
+    scan.port_verdicts.clear();
+  }
+  scan.tc = tc;
+  scan.name = name;
+  scan.port_filter = m_port_filter.active() ? &m_port_filter : 0;
+  scan.channel_stats = m_channel_stats;
+  scan.operations = m_operations;
+  m_names.insert(name, 0);
+  return scan;
+}
+
+bool Dot::acceptPeer(TaskContext* tc, unsigned int name)
+{
+  if(!m_component_filter.active())
+  {
+    return true;
+  }
+  unsigned int verdict = m_component_verdicts.find(name);
+  if(verdict == NameIndex::npos)
+  {
+    verdict = m_component_filter.accept(m_current.graph.str(name)) ? 1 : 0;
+    m_component_verdicts.insert(name, verdict);
+  }
+  if(verdict == 0)
+  {
+    m_excluded_peers.insert(tc, 0);
+  }
+  return verdict != 0;
+}
+
+void Dot::findPeers()
+{
+  m_num_scans = 0;
+  m_visited.clear();
+  m_names.clear();
+  m_excluded_peers.clear();
+  m_visited.insert(this->getOwner(), 0);
+  if(m_component_filter.set(m_component_include, m_component_exclude))
+  {
+    m_component_verdicts.clear();
+  }
+  m_port_filter.set(m_port_include, m_port_exclude);
+
+  // List all peers of this component
+  std::vector<std::string> peerList = this->getOwner()->getPeerList();
+  for(unsigned int i = 0; i < peerList.size(); i++)
+  {
+    // Get a pointer to the taskcontext, which can be either a peer or the component itself.
+    TaskContext* tc = this->getOwner()->getPeer(peerList[i]);
+    if(tc == 0)
+    {
+      tc = this->getOwner();
+    }
+    m_visited.insert(tc, 0);
+    unsigned int name = m_current.graph.intern(peerList[i]);
+    if(acceptPeer(tc, name))
+    {
+      addPeer(tc, name);
+    }
+  }
+  if(!m_recursive)
+  {
+    return;
+  }
+
+  // Breadth first over the peers of peers; peer links can form cycles, so every context is only added once
+  for(unsigned int i = 0; i < m_num_scans; i++)
+  {
+    TaskContext* parent = m_scans[i].tc;
+    if(parent == this->getOwner())
+    {
+      continue;
+    }
+    std::vector<std::string> peers = parent->getPeerList();
+    for(unsigned int j = 0; j < peers.size(); j++)
+    {
+      TaskContext* tc = parent->getPeer(peers[j]);
+      if(tc == 0 || m_visited.find(tc) != PeerIndex::npos)
+      {
+        continue;
+      }
+      m_visited.insert(tc, 0);
+      // Nested peers are named as their parent knows them; the parent name tells apart equally named ones
+      unsigned int name = m_current.graph.intern(peers[j]);
+      if(m_names.find(name) != NameIndex::npos)
+      {
+        name = m_current.graph.intern(m_current.graph.str(m_scans[i].name) + "." + peers[j]);
+      }
+      // Excluded peers are not scanned, so neither are their own peers
+      if(acceptPeer(tc, name))
+      {
+        addPeer(tc, name);
       }
     }
-    // Recurse for sub services
-    Service::ProviderNames providers = sv->getProviderNames();
-    for(Service::ProviderNames::iterator it=providers.begin(); it != providers.end(); ++it) {
-          scanService(path + "." + sv->getName(), sv->provides(*it));
+  }
+}
+
+bool Dot::scan()
+{
+  m_peers.clear();
+  m_ports.clear();
+  m_channels.clear();
+  m_excluded_ports.clear();
+  m_calls.clear();
+  m_peer_index.clear();
+  m_structure = fnv_offset;
+  m_state = fnv_offset;
+
+  findPeers();
+  // What is drawn also depends on the filters and clusters
+  hashValue(m_structure, m_component_filter.generation());
+  hashValue(m_structure, m_port_filter.generation());
+  hashValue(m_structure, m_collapse_clusters);
+  hashValue(m_structure, m_bundle_fanout);
+  hashValue(m_structure, m_timing);
+  hashValue(m_structure, m_channel_stats);
+  hashValue(m_structure, m_operations);
+  ClusterMode mode = clusterMode();
+  if(m_num_scans == 0)
+  {
+    log(Debug) << "Component has no peers!" << endlog();
+    if(!m_samplers.empty() || !m_retired_samplers.empty())
+    {
+      retireSamplers(true);
     }
+    return false;
+  }
+
+  // Peers are scanned independently, possibly in parallel, and merged in their order
+  if(m_scan_threads > 0 && m_num_scans > 1 && m_pool.resize(m_scan_threads, m_scan_priority > 0 ? ORO_SCHED_RT : ORO_SCHED_OTHER, m_scan_priority, m_scan_cpu_affinity))
+  {
+    m_pool.run(m_scan_job, m_num_scans);
+  }
+  else
+  {
+    for(unsigned int i = 0; i < m_num_scans; i++)
+    {
+      scanPeer(m_scans[i]);
+    }
+  }
+
+  for(unsigned int i = 0; i < m_num_scans; i++)
+  {
+    const PeerScan& scan = m_scans[i];
+    m_peers.push_back(PeerEntry());
+    PeerEntry& peer = m_peers.back();
+    peer.name = scan.name;
+    peer.state = scan.state;
+    peer.first_port = m_ports.size();
+    m_peer_index.insert(scan.tc, i);
+    peer.cluster = mode == NoClusters ? DotGraph::empty : cluster(scan);
+    hashString(m_structure, m_current.graph.str(scan.name));
+    hashValue(m_structure, peer.cluster);
+    hashValue(m_structure, scan.structure);
+    hashValue(m_state, peer.state);
+
+    m_path_ids.resize(scan.num_paths);
+    for(unsigned int j = 0; j < scan.num_paths; j++)
+    {
+      m_path_ids[j] = m_current.graph.intern(scan.paths[j]);
+    }
+    for(unsigned int j = 0; j < scan.ports.size(); j++)
+    {
+      m_ports.push_back(scan.ports[j]);
+      m_ports.back().path = m_path_ids[scan.ports[j].path];
+      m_ports.back().peer = i;
+    }
+    for(unsigned int j = 0; j < scan.channels.size(); j++)
+    {
+      m_channels.push_back(scan.channels[j]);
+      ChannelEntry& ch = m_channels.back();
+      ch.port += peer.first_port;
+      if(ch.buffer != 0)
+      {
+        ch.stats.drop_rate = dropRate(ch.buffer, ch.stats.dropped);
+        // Fill levels only count as a change once they moved to another tenth
+        unsigned int bucket = ch.stats.capacity > 0 ? ch.stats.fill * 10 / ch.stats.capacity : 0;
+        hashValue(m_state, bucket);
+        hashValue(m_state, ch.stats.dropped);
+      }
+    }
+    for(unsigned int j = 0; j < scan.excluded.size(); j++)
+    {
+      m_excluded_ports.insert(scan.excluded[j], 0);
+    }
+    for(unsigned int j = 0; j < scan.calls.size(); j++)
+    {
+      m_calls.push_back(scan.calls[j]);
+      CallEntry& call = m_calls.back();
+      call.peer = i;
+      call.service = m_current.graph.intern(scan.call_names[call.service]);
+      call.operation = m_current.graph.intern(scan.call_names[call.operation]);
+    }
+  }
+  sweepDropWindows();
+
+  if(m_timing)
+  {
+    sampleTimings();
+  }
+  if(!m_samplers.empty() || !m_retired_samplers.empty())
+  {
+    retireSamplers(!m_timing);
+  }
+  return true;
 }
 
-std::string Dot::appendToPath(const std::string& path,const std::string& sub)
+unsigned int Dot::activityKind(base::ActivityInterface* activity) const
 {
-    if(path.empty())
-        return sub;
-    return path + "." + sub;
+  if(activity == 0)
+    return m_activity_kinds[0];
+  if(dynamic_cast<Activity*>(activity) != 0)
+    return m_activity_kinds[1];
+  if(dynamic_cast<extras::SlaveActivity*>(activity) != 0)
+    return m_activity_kinds[2];
+  if(dynamic_cast<extras::SequentialActivity*>(activity) != 0)
+    return m_activity_kinds[3];
+  if(dynamic_cast<extras::FileDescriptorActivity*>(activity) != 0)
+    return m_activity_kinds[4];
+  return m_activity_kinds[5];
 }
 
-void Dot::buildComponentOutputPortsMap(std::string path, Service::shared_ptr sv, int& current_count)
+DotStepSampler* Dot::sampler(TaskContext* tc)
 {
-    std::vector<std::string> comp_ports = sv->getPortNames();
-    // Build the output ports
-    for(unsigned int j = 0; j < comp_ports.size(); j++)
+  unsigned int index = m_sampler_index.find(tc);
+  if(index == PeerIndex::npos)
+  {
+    index = m_samplers.size();
+    m_samplers.push_back(SamplerEntry());
+    m_samplers.back().tc = tc;
+    m_samplers.back().sampler.reset(new DotStepSampler());
+    m_sampler_index.insert(tc, index);
+  }
+  m_samplers[index].seen = true;
+  DotStepSampler* sampler = m_samplers[index].sampler.get();
+  // Engines unload their functions when they stop or go away, so a sampler is loaded again when needed
+  if(!sampler->inEngine() && !sampler->load(tc->engine()))
+  {
+    log(Debug) << "Unable to measure the steps of " << tc->getName() << endlog();
+  }
+  return sampler;
+}
+
+void Dot::sampleTimings()
+{
+  m_thread_users.clear();
+  m_peer_threads.resize(m_peers.size());
+  for(unsigned int i = 0; i < m_peers.size(); i++)
+  {
+    TaskContext* tc = m_scans[i].tc;
+    DotGraph::Timing& timing = m_peers[i].timing;
+    base::ActivityInterface* activity = tc->getActivity();
+    os::ThreadInterface* thread = activity ? activity->thread() : 0;
+    m_peer_threads[i] = thread;
+    timing.activity = activityKind(activity);
+    timing.period = activity && activity->isPeriodic() ? activity->getPeriod() : 0;
+    timing.cpu_affinity = activity ? activity->getCpuAffinity() : ~0u;
+    timing.realtime = thread && thread->getScheduler() == ORO_SCHED_RT;
+    timing.priority = thread ? thread->getPriority() : 0;
+    if(thread)
+    {
+      unsigned int users = m_thread_users.find(thread);
+      m_thread_users.insert(thread, users == ThreadIndex::npos ? 1 : users + 1);
+    }
+    DotStepSampler* sampler = this->sampler(tc);
+    sampler->setWindow(m_timing_window);
+    sampler->read(timing);
+  }
+
+  for(unsigned int i = 0; i < m_peers.size(); i++)
+  {
+    DotGraph::Timing& timing = m_peers[i].timing;
+    timing.thread_users = m_peer_threads[i] ? m_thread_users.find(m_peer_threads[i]) : 1;
+    hashValue(m_structure, timing.activity);
+    hashValue(m_structure, timing.period);
+    hashValue(m_structure, timing.realtime);
+    hashValue(m_structure, timing.priority);
+    hashValue(m_structure, timing.cpu_affinity);
+    hashValue(m_structure, timing.thread_users);
+    // Measurements only count as a change once the load moved to another tenth
+    int bucket = timing.steps > 0 ? int(timing.load * 10) : -1;
+    hashValue(m_state, bucket);
+  }
+}
+
+void Dot::retireSamplers(bool all)
+{
+  unsigned int kept = 0;
+  for(unsigned int i = 0; i < m_samplers.size(); i++)
+  {
+    SamplerEntry& entry = m_samplers[i];
+    if(all || !entry.seen)
     {
-    bool is_output_port = (dynamic_cast<base::OutputPortInterface*>(sv->getPort(comp_ports[j])) != 0);
-    if(is_output_port)
+      entry.sampler->retire();
+      m_retired_samplers.push_back(std::move(entry.sampler));
+      continue;
+    }
+    entry.seen = false;
+    if(kept != i)
     {
-        comp_ports_map[mpeer][comp_ports[j]] = "o" + std::to_string(current_count);
-        m_dot << (current_count>0 ? " | ":"") << "<o" << std::to_string(current_count) <<">"<< comp_ports[j];
-        current_count++;
+      m_samplers[kept] = std::move(entry);
     }
+    kept++;
+  }
+  if(kept != m_samplers.size())
+  {
+    m_samplers.resize(kept);
+    m_sampler_index.clear();
+    for(unsigned int i = 0; i < m_samplers.size(); i++)
+    {
+      m_sampler_index.insert(m_samplers[i].tc, i);
     }
-    // recurse for ouputs
-    Service::ProviderNames providers = sv->getProviderNames();
-    for(Service::ProviderNames::iterator it=providers.begin(); it != providers.end(); ++it) {
-        buildComponentOutputPortsMap(appendToPath(path , sv->getName()), sv->provides(*it) ,current_count);
+  }
+  // A retired sampler stays until its engine stepped and unloaded it
+  for(unsigned int i = 0; i < m_retired_samplers.size();)
+  {
+    if(m_retired_samplers[i]->inEngine())
+    {
+      i++;
+      continue;
+    }
+    m_retired_samplers[i] = std::move(m_retired_samplers.back());
+    m_retired_samplers.pop_back();
+  }
+}
+
+double Dot::dropRate(const void* buffer, unsigned int dropped)
+{
+  os::TimeService* ts = os::TimeService::Instance();
+  m_drop_sampled++;
+  unsigned int index = m_drop_index.find(buffer);
+  if(index == BufferIndex::npos)
+  {
+    index = m_drop_windows.size();
+    DropWindow window = { buffer, dropped, ts->getTicks(), 0.0, m_drop_generation };
+    m_drop_windows.push_back(window);
+    m_drop_index.insert(buffer, index);
+    return 0.0;
+  }
+  DropWindow& window = m_drop_windows[index];
+  window.generation = m_drop_generation;
+  if(dropped < window.dropped)
+  {
+    // Another buffer at the same address
+    window.dropped = dropped;
+    window.start = ts->getTicks();
+    window.rate = 0.0;
+    return 0.0;
+  }
+  double elapsed = ts->secondsSince(window.start);
+  if(elapsed >= m_timing_window && elapsed > 0)
+  {
+    window.rate = (dropped - window.dropped) / elapsed;
+    window.dropped = dropped;
+    window.start = ts->getTicks();
+  }
+  return window.rate;
+}
+
+void Dot::sweepDropWindows()
+{
+  // Compacting keeps the windows of the buffers still sampled, and their rates
+  if(m_drop_windows.size() > 2 * m_drop_sampled + 64)
+  {
+    unsigned int kept = 0;
+    m_drop_index.clear();
+    for(unsigned int i = 0; i < m_drop_windows.size(); i++)
+    {
+      if(m_drop_windows[i].generation == m_drop_generation)
+      {
+        m_drop_windows[kept] = m_drop_windows[i];
+        m_drop_index.insert(m_drop_windows[kept].buffer, kept);
+        kept++;
+      }
     }
+    m_drop_windows.resize(kept);
+  }
+  m_drop_generation++;
+  m_drop_sampled = 0;
 }
 
-void Dot::buildComponentInputPortsMap(std::string path, Service::shared_ptr sv, int& current_count)
+Dot::ClusterMode Dot::clusterMode()
 {
-    log(Debug) << "Dot::buildComponentInputPortsMap path=" << path << " sv=" << sv->getName() << " current_count=" << current_count << endlog();
+  if(m_cluster_by != m_parsed_cluster_by)
+  {
+    m_parsed_cluster_by = m_cluster_by;
+    if(m_cluster_by == "none" || m_cluster_by.empty())
+      m_cluster_mode = NoClusters;
+    else if(m_cluster_by == "prefix")
+      m_cluster_mode = PrefixClusters;
+    else if(m_cluster_by == "activity")
+      m_cluster_mode = ActivityClusters;
+    else
+    {
+      log(Warning) << "Unknown cluster_by '" << m_cluster_by << "', not clustering" << endlog();
+      m_cluster_mode = NoClusters;
+    }
+  }
+  return m_cluster_mode;
+}
 
-    // Build the input ports
-    for(auto port : sv->getPortNames())
+unsigned int Dot::cluster(const PeerScan& scan)
+{
+  if(m_cluster_mode == PrefixClusters)
+  {
+    const std::string& name = m_current.graph.str(scan.name);
+    std::string::size_type end = name.find_first_of(m_cluster_separators);
+    if(end == std::string::npos || end == 0)
     {
-        std::cout << "     port " << port << endlog();
-        bool is_input_port = (dynamic_cast<base::InputPortInterface*>(sv->getPort(port)) != 0);
-        if(is_input_port)
-        {
-            log(Debug) << "         ---> is input" << endlog();
-            comp_ports_map[mpeer][port] = "i" + std::to_string(current_count);
-            m_dot << (current_count>0 ? " | ":"") << "<i" << std::to_string(current_count) <<">"<< port;
-            current_count++;
-        }
+      return DotGraph::empty;
     }
-//     for(auto operation_name : sv->getOperationNames())
-//     {
-//         std::cout << "     operation " << operation_name << endlog();
-//         auto operation = sv->getOperation(operation_name);
-//         log(Debug) << "         ---> is input" << endlog();
-//         comp_ports_map[mpeer][operation_name] = "i" + std::to_string(current_count);
-//         m_dot << (current_count>0 ? " | ":"") << "<i" << std::to_string(current_count) <<">"<< operation_name;
-//         current_count++;
-//     }
-    // recurse for inputs
-    Service::ProviderNames providers = sv->getProviderNames();
-    for(Service::ProviderNames::iterator it=providers.begin(); it != providers.end(); ++it)
+    m_cluster_name.assign(name, 0, end);
+  }
+  else
+  {
+    base::ActivityInterface* activity = scan.tc->getActivity();
+    if(activity == 0 || activity->thread() == 0)
+    {
+      return DotGraph::empty;
+    }
+    m_cluster_name.assign(activity->thread()->getName());
+  }
+  return m_current.graph.intern(m_cluster_name);
+}
+
+void Dot::buildGraph(DotGraph& graph)
+{
+  graph.clear();
+  graph.timestamp = os::TimeService::Instance()->getNSecs();
+  graph.structure_hash = m_structure;
+  graph.state_hash = m_state;
+
+  m_port_index.clear();
+  for(unsigned int i = 0; i < m_ports.size(); i++)
+  {
+    m_port_index.insert(m_ports[i].port, i);
+  }
+
+  // Ports were scanned peer by peer, so the port table keeps its order
+  for(unsigned int i = 0; i < m_peers.size(); i++)
+  {
+    graph.addComponent(m_peers[i].name, m_peers[i].state, m_peers[i].cluster);
+    if(m_timing)
+    {
+      graph.setTiming(i, m_peers[i].timing);
+    }
+    unsigned int end = i + 1 < m_peers.size() ? m_peers[i + 1].first_port : m_ports.size();
+    for(unsigned int j = m_peers[i].first_port; j < end; j++)
+    {
+      const PortEntry& entry = m_ports[j];
+      graph.addPort(entry.path, graph.intern(entry.port->getName()), entry.direction, entry.field);
+    }
+  }
+
+  for(unsigned int i = 0; i < m_calls.size(); i++)
+  {
+    const CallEntry& entry = m_calls[i];
+    DotGraph::Call call;
+    call.caller = entry.peer;
+    call.callee = m_peer_index.find(entry.callee);
+    call.callee_name = DotGraph::npos;
+    if(call.callee == PeerIndex::npos)
+    {
+      // A callee outside of the peers is drawn as a plain node, unless it was filtered out
+      if(m_excluded_peers.find(entry.callee) != PeerIndex::npos)
+      {
+        continue;
+      }
+      call.callee = DotGraph::npos;
+      call.callee_name = graph.intern(entry.callee->getName());
+    }
+    call.service = entry.service;
+    call.operation = entry.operation;
+    call.own_thread = entry.own_thread;
+    call.remote = entry.remote;
+    call.guessed = entry.guessed;
+    graph.addCall(call);
+  }
+
+  for(unsigned int i = 0; i < m_channels.size(); i++)
+  {
+    const ChannelEntry& entry = m_channels[i];
+    DotGraph::Channel ch;
+    ch.at_input_port = m_ports[entry.port].direction == DotGraph::Input;
+    ch.type = entry.policy.type;
+    ch.size = entry.policy.size;
+    ch.lock_policy = entry.policy.lock_policy;
+    ch.transport = entry.policy.transport;
+    ch.init = entry.policy.init;
+    ch.pull = entry.policy.pull;
+    ch.name_id = graph.intern(entry.policy.name_id);
+    if(!resolve(entry.writer, ch.writer, ch.writer_comp, m_free_input) || !resolve(entry.reader, ch.reader, ch.reader_comp, m_free_output))
+    {
+      continue;
+    }
+    unsigned int index = graph.addChannel(ch);
+    // Both ends of a connection reach the same buffer
+    if(entry.buffer != 0)
+    {
+      graph.setChannelStats(index, entry.stats);
+    }
+  }
+}
+
+bool Dot::resolve(base::PortInterface* port, unsigned int& index, unsigned int& comp, unsigned int free_name)
+{
+  index = DotGraph::npos;
+  comp = DotGraph::npos;
+  if(port == 0)
+  {
+    return true;
+  }
+  index = m_port_index.find(port);
+  if(index != PortIndex::npos)
+  {
+    return true;
+  }
+  index = DotGraph::npos;
+  if(m_excluded_ports.find(port) != PortIndex::npos)
+  {
+    return false;
+  }
+  // A port outside of the peers, draw its owner as a plain node
+  if(port->getInterface() != 0)
+  {
+    if(m_excluded_peers.find(port->getInterface()->getOwner()) != PeerIndex::npos)
     {
-        buildComponentInputPortsMap(appendToPath(path , sv->getName()), sv->provides(*it),current_count);
+      return false;
     }
+    comp = m_current.graph.intern(port->getInterface()->getOwner()->getName());
+  }
+  else
+  {
+    comp = free_name;
+  }
+  return true;
 }
 
+Dot::TriggerMode Dot::triggerMode()
+{
+  if(m_trigger_mode != m_parsed_trigger_mode)
+  {
+    m_parsed_trigger_mode = m_trigger_mode;
+    if(m_trigger_mode == "update")
+      m_mode = EveryUpdate;
+    else if(m_trigger_mode == "periodic")
+      m_mode = Periodic;
+    else if(m_trigger_mode == "on_demand")
+      m_mode = OnDemand;
+    else if(m_trigger_mode == "event")
+      m_mode = Event;
+    else
+    {
+      log(Warning) << "Unknown trigger_mode '" << m_trigger_mode << "', generating on every update" << endlog();
+      m_mode = EveryUpdate;
+    }
+  }
+  return m_mode;
+}
 
 bool Dot::execute()
 {
-  m_dot.str("");
-  m_dot << "digraph G { \n";
-  m_dot << "graph[splines=true, overlap=false] \n";
-  m_dot << "rankdir=LR; \n";
-  m_dot << "nodesep=0.5; \n";
-  m_dot << "ranksep=1.5; \n";
-  m_dot << "fontname=\"sans\";\n";
-  // m_dot << "labelloc=\"t\";\n";
-  // m_dot << "fontsize=25;\n";
-  // m_dot << "label=" << this->getOwner()->getName()<<";\n";
-  m_dot << "node [style=\"rounded,filled\",fontsize=15,color=\"#777777\",fillcolor=\"#eeeeee\"];\n";
-  // List all peers of this component
-  std::vector<std::string> peerList = this->getOwner()->getPeerList();
-  // Add the component itself as well
-  if(peerList.size() == 0)
+  switch(triggerMode())
+  {
+    case OnDemand:
+      return true;
+    case Periodic:
+      if(m_last_update != 0 && os::TimeService::Instance()->secondsSince(m_last_update) < m_min_period)
+      {
+        return true;
+      }
+      m_last_update = os::TimeService::Instance()->getTicks();
+      return update(false);
+    case Event:
+      return debounce();
+    case EveryUpdate:
+    default:
+      return update(false);
+  }
+}
+
+bool Dot::generate()
+{
+  m_pending = false;
+  return update(true);
+}
+
+bool Dot::changed()
+{
+  if(m_write_failed.exchange(false))
+  {
+    m_has_fingerprint = false;
+  }
+  return !m_has_fingerprint || m_structure != m_structure_hash || m_state != m_state_hash;
+}
+
+bool Dot::debounce()
+{
+  if(!scan())
   {
-    log(Debug) << "Component has no peers!" << endlog();
     return false;
   }
+  if(!changed())
+  {
+    m_pending = false;
+    m_skip_count++;
+    return true;
+  }
 
-  // Reset the map
-  comp_ports_map.clear();
+  os::TimeService* ts = os::TimeService::Instance();
+  os::TimeService::ticks now = ts->getTicks();
+  bool first = !m_pending;
+  if(first)
+  {
+    m_pending = true;
+    m_pending_since = now;
+  }
+  if(first || m_structure != m_pending_structure || m_state != m_pending_state)
+  {
+    m_pending_structure = m_structure;
+    m_pending_state = m_state;
+    m_last_change = now;
+  }
 
-  for(unsigned int i = 0; i < peerList.size(); i++)
+  // Wait until the deployment settled, but not forever if it keeps changing
+  if(ts->secondsSince(m_last_change) < m_debounce && ts->secondsSince(m_pending_since) < 10 * m_debounce)
   {
-    mpeer = peerList[i];
-    log(Debug) <<"["<<i<<"] Component: " << mpeer << endlog();
-    // Get a pointer to the taskcontext, which can be either a peer or the component itself.
-    TaskContext* tc = this->getOwner()->getPeer(mpeer);
-    if(tc == 0)
+    m_skip_count++;
+    return true;
+  }
+  m_pending = false;
+  return publish();
+}
+
+bool Dot::update(bool force)
+{
+  if(!scan())
+  {
+    return false;
+  }
+  if(!force && !changed())
+  {
+    m_skip_count++;
+    return true;
+  }
+  return publish();
+}
+
+bool Dot::publish()
+{
+  buildGraph(m_current.graph);
+  parseFormats();
+  m_current.options.conn_args = m_conn_args;
+  m_current.options.collapse_clusters = m_collapse_clusters;
+  m_current.options.bundle_fanout = m_bundle_fanout;
+  m_current.options.timing = m_timing;
+  m_current.options.channel_stats = m_channel_stats;
+  const std::string* files[NumFormats] = { &m_dot_file, &m_json_file, &m_binary_file, &m_delta_file, &m_layout_file, &m_record_file };
+  for(unsigned int i = 0; i < NumFormats; i++)
+  {
+    if(m_selected[i])
+      m_current.files[i] = *files[i];
+    else
+      m_current.files[i].clear();
+  }
+  m_current.stream_socket = m_stream_socket;
+  m_current.stream_max_lag = m_stream_max_lag;
+  m_current.layout_command = m_layout_command;
+  m_current.layout_cache_dir = m_layout_cache_dir;
+  m_current.worker_priority = m_worker_priority;
+  m_current.worker_cpu_affinity = m_worker_cpu_affinity;
+  // Graphviz must not run in execute(), which writes the snapshot itself in sync mode
+  if(!m_async && !m_current.files[LayoutFormat].empty())
+  {
+    if(!m_layout_rejected)
     {
-      tc = this->getOwner();
+      log(Warning) << "The layout format is only written in async mode, not writing " << m_layout_file << endlog();
+      m_layout_rejected = true;
     }
+    m_current.files[LayoutFormat].clear();
+  }
+  else
+  {
+    m_layout_rejected = false;
+  }
+  bool recorded = record();
 
-    base::TaskCore::TaskState st = tc->getTaskState();
+  if(m_async)
+  {
+    if(!startWorker())
+    {
+      return false;
+    }
+    Snapshot& snapshot = m_handoff.back();
+    snapshot.graph.assign(m_current.graph);
+    snapshot.options.conn_args = m_current.options.conn_args;
+    snapshot.options.collapse_clusters = m_current.options.collapse_clusters;
+    snapshot.options.bundle_fanout = m_current.options.bundle_fanout;
+    snapshot.options.timing = m_current.options.timing;
+    snapshot.options.channel_stats = m_current.options.channel_stats;
+    for(unsigned int i = 0; i < NumFormats; i++)
+    {
+      snapshot.files[i] = m_current.files[i];
+    }
+    snapshot.stream_socket = m_current.stream_socket;
+    snapshot.stream_max_lag = m_current.stream_max_lag;
+    snapshot.layout_command = m_current.layout_command;
+    snapshot.layout_cache_dir = m_current.layout_cache_dir;
+    snapshot.worker_priority = m_current.worker_priority;
+    snapshot.worker_cpu_affinity = m_current.worker_cpu_affinity;
+    if(!m_handoff.publish())
+    {
+      m_coalesce_count++;
+    }
+    m_worker->trigger();
+  }
+  else
+  {
+    // Never write from both threads at the same time
+    stopWorker();
+    if(!writeSnapshot(m_current))
+    {
+      return false;
+    }
+  }
+  m_has_fingerprint = true;
+  m_structure_hash = m_structure;
+  m_state_hash = m_state;
+  m_generate_count++;
+  return recorded;
+}
 
-    std::string st_str,color;
-    switch (st)
+bool Dot::writeSnapshot(const Snapshot& snapshot)
+{
+  // Every format renders the same snapshot
+  bool ok = true;
+  for(unsigned int i = 0; i < NumFormats; i++)
+  {
+    if(snapshot.files[i].empty() || !m_backends[i])
     {
-        case base::TaskCore::Init          : st_str = "Init          ";color = "white";       break;
-        case base::TaskCore::PreOperational: st_str = "PreOperational";color = "orange";      break;
-        case base::TaskCore::FatalError    : st_str = "FatalError    ";color = "red";         break;
-        case base::TaskCore::Exception     : st_str = "Exception     ";color = "red";         break;
-        case base::TaskCore::Stopped       : st_str = "Stopped       ";color = "lightblue";   break;
-        case base::TaskCore::Running       : st_str = "Running       ";color = "#4ec167";     break;
-        case base::TaskCore::RunTimeError  : st_str = "RunTimeError  ";color = "red";         break;
+      continue;
     }
+    m_out.clear();
+    m_backends[i]->render(snapshot.graph, snapshot.options, m_out);
+    if(!m_out.writeFile(snapshot.files[i]))
+    {
+      log(Debug) << "Unable to write file: " << snapshot.files[i] << endlog();
+      ok = false;
+    }
+  }
+  if(!writeDelta(snapshot))
+  {
+    ok = false;
+  }
+  const std::string& layout_file = snapshot.files[LayoutFormat];
+  if(!layout_file.empty() && !m_layout.write(snapshot.graph, snapshot.options, snapshot.layout_command, snapshot.layout_cache_dir, layout_file, m_out))
+  {
+    log(Debug) << "Unable to write file: " << layout_file << endlog();
+    ok = false;
+  }
 
-    m_dot << quote(mpeer) << "[shape=record,fillcolor=\""<<color<<"\",label=\"\\N|{{";
-    int current_count = 0;
-    buildComponentInputPortsMap("",tc->provides(),current_count);
-    m_dot << " } | | { ";
-    current_count = 0;
-    buildComponentOutputPortsMap("",tc->provides(),current_count);
-    m_dot << "}}\"];\n";
+  if(!m_stream.open(snapshot.stream_socket, snapshot.worker_priority, snapshot.worker_cpu_affinity))
+  {
+    ok = false;
   }
-  // Loop over all peers + own component
-  for(unsigned int i = 0; i < peerList.size(); i++)
+  else if(!snapshot.stream_socket.empty())
   {
-    mpeer = peerList[i];
-    log(Debug) <<"["<<i<<"] Component: " << mpeer << endlog();
-    // Get a pointer to the taskcontext, which can be either a peer or the component itself.
-    TaskContext* tc = this->getOwner()->getPeer(mpeer);
-    if(this->getOwner()->getPeer(mpeer) == 0)
+    m_out.clear();
+    size_t frame = DotBinaryEmitter::beginFrame(m_out, DotBinaryFrame::SnapshotFrame, snapshot.graph.timestamp);
+    m_binary_emitter.render(snapshot.graph, snapshot.options, m_out);
+    DotBinaryEmitter::endFrame(m_out, frame);
+    m_stream.publish(m_out.data(), m_out.size(), snapshot.stream_max_lag);
+  }
+  return ok;
+}
+
+bool Dot::writeDelta(const Snapshot& snapshot)
+{
+  const std::string& path = snapshot.files[DeltaFormat];
+  if(path != m_delta_path)
+  {
+    closeDelta();
+    if(path.empty())
     {
-      tc = this->getOwner();
+      return true;
+    }
+    m_delta_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if(m_delta_fd < 0)
+    {
+      log(Debug) << "Unable to open file: " << path << endlog();
+      return false;
     }
+    m_delta_path = path;
+  }
+  else if(path.empty())
+  {
+    return true;
+  }
 
-    // Draw in/out ports
-    scanService("",tc->provides());
+  // The log starts with a full snapshot, so that it can be replayed on its own
+  m_out.clear();
+  size_t frame;
+  if(!m_has_previous)
+  {
+    frame = DotBinaryEmitter::beginFrame(m_out, DotBinaryFrame::SnapshotFrame, snapshot.graph.timestamp);
+    m_binary_emitter.render(snapshot.graph, snapshot.options, m_out);
+  }
+  else
+  {
+    m_delta.compute(m_previous, snapshot.graph);
+    if(m_delta.empty())
+    {
+      return true;
+    }
+    frame = DotBinaryEmitter::beginFrame(m_out, DotBinaryFrame::DeltaFrame, snapshot.graph.timestamp);
+    m_delta.render(snapshot.graph, m_out);
   }
-  m_dot << "}\n";
-  std::ofstream fl(m_dot_file.c_str());
-  if (fl.is_open())
+  DotBinaryEmitter::endFrame(m_out, frame);
+  m_previous.assign(snapshot.graph);
+  m_has_previous = true;
+  if(!m_out.writeTo(m_delta_fd))
+  {
+    log(Debug) << "Unable to write file: " << path << endlog();
+    // Start over with a full snapshot, the log cannot be replayed past this point anyway
+    closeDelta();
+    return false;
+  }
+  return true;
+}
+
+void Dot::closeDelta()
+{
+  if(m_delta_fd >= 0)
+  {
+    ::close(m_delta_fd);
+    m_delta_fd = -1;
+  }
+  m_delta_path.clear();
+  m_has_previous = false;
+}
+
+bool Dot::record()
+{
+  const std::string& path = m_current.files[RecordFormat];
+  if(path != m_recorder.path() || (!path.empty() && m_record_size != m_recorder.size()))
+  {
+    m_has_recorded = false;
+    if(!m_recorder.open(path, m_record_size))
+    {
+      log(Error) << "Unable to map recording: " << path << endlog();
+      return false;
+    }
+  }
+  if(path.empty())
   {
-    fl << m_dot.str();
-    fl.close();
     return true;
   }
+
+  // Deltas need the snapshot before them, which is overwritten first
+  m_record_out.clear();
+  size_t frame;
+  if(!m_has_recorded || m_recorder.sinceSnapshot() > m_recorder.capacity() / 4)
+  {
+    frame = DotBinaryEmitter::beginFrame(m_record_out, DotBinaryFrame::SnapshotFrame, m_current.graph.timestamp);
+    m_record_emitter.render(m_current.graph, m_current.options, m_record_out);
+  }
   else
   {
-    log(Debug) << "Unable to open file: " << m_dot_file << endlog();
+    m_record_delta.compute(m_recorded, m_current.graph);
+    if(m_record_delta.empty())
+    {
+      return true;
+    }
+    frame = DotBinaryEmitter::beginFrame(m_record_out, DotBinaryFrame::DeltaFrame, m_current.graph.timestamp);
+    m_record_delta.render(m_current.graph, m_record_out);
+  }
+  DotBinaryEmitter::endFrame(m_record_out, frame);
+  m_recorded.assign(m_current.graph);
+  m_has_recorded = m_recorder.append(m_record_out.data(), m_record_out.size());
+  if(!m_has_recorded)
+  {
+    log(Warning) << "Snapshot of " << (unsigned int)m_record_out.size() << " bytes does not fit in recording: " << path << endlog();
+  }
+  return true;
+}
+
+void Dot::parseFormats()
+{
+  if(m_formats == m_parsed_formats)
+  {
+    return;
+  }
+  m_parsed_formats = m_formats;
+  for(unsigned int i = 0; i < NumFormats; i++)
+  {
+    m_selected[i] = false;
+  }
+  std::string::size_type start = 0;
+  while(start <= m_formats.size())
+  {
+    std::string::size_type end = m_formats.find(',', start);
+    if(end == std::string::npos)
+    {
+      end = m_formats.size();
+    }
+    std::string format = m_formats.substr(start, end - start);
+    format.erase(0, format.find_first_not_of(" \t"));
+    format.erase(format.find_last_not_of(" \t") + 1);
+    if(format == "dot")
+      m_selected[DotFormat] = true;
+    else if(format == "json")
+      m_selected[JsonFormat] = true;
+    else if(format == "binary")
+      m_selected[BinaryFormat] = true;
+    else if(format == "delta")
+      m_selected[DeltaFormat] = true;
+    else if(format == "layout")
+      m_selected[LayoutFormat] = true;
+    else if(format == "record")
+      m_selected[RecordFormat] = true;
+    else if(!format.empty())
+      log(Warning) << "Unknown output format '" << format << "' in formats" << endlog();
+    start = end + 1;
+  }
+}
+
+bool Dot::startWorker()
+{
+  if(!m_worker)
+  {
+    m_worker.reset(new Activity(ORO_SCHED_OTHER, m_worker_priority, 0.0, m_worker_cpu_affinity, &m_runner, "DotWorker"));
+    m_applied_priority = m_worker_priority;
+    m_applied_cpu_affinity = m_worker_cpu_affinity;
+  }
+  if(m_applied_priority != m_worker_priority)
+  {
+    m_worker->thread()->setPriority(m_worker_priority);
+    m_applied_priority = m_worker_priority;
+  }
+  if(m_applied_cpu_affinity != m_worker_cpu_affinity)
+  {
+    m_worker->thread()->setCpuAffinity(m_worker_cpu_affinity);
+    m_applied_cpu_affinity = m_worker_cpu_affinity;
+  }
+  if(!m_worker->isActive() && !m_worker->start())
+  {
+    log(Error) << "Unable to start the dot worker thread" << endlog();
     return false;
   }
+  return true;
+}
+
+void Dot::stopWorker()
+{
+  if(m_worker && m_worker->isActive())
+  {
+    m_worker->stop();
+    // Write out what was published but not yet written
+    flush();
+  }
+}
+
+void Dot::flush()
+{
+  if(m_handoff.consume() && !writeSnapshot(m_handoff.front()))
+  {
+    m_write_failed.store(true);
+  }
+}
+
+void DotWorker::step()
+{
+  m_dot->flush();
 }
 ORO_SERVICE_NAMED_PLUGIN(Dot, "dot")
@@ -43,21 +43,64 @@
 
 #include <rtt/plugin/ServicePlugin.hpp>
 #include <rtt/base/ExecutableInterface.hpp>
+#include <rtt/base/RunnableInterface.hpp>
 #include <rtt/base/TaskCore.hpp>
+#include <rtt/Activity.hpp>
+#include <rtt/os/TimeService.hpp>
 #include <rtt/RTT.hpp>
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include "dot_binary.hpp"
+#include "dot_delta.hpp"
+#include "dot_emitter.hpp"
+#include "dot_filter.hpp"
+#include "dot_flat_map.hpp"
+#include "dot_graph.hpp"
+#include "dot_handoff.hpp"
+#include "dot_json.hpp"
+#include "dot_layout.hpp"
+#include "dot_pool.hpp"
+#include "dot_recorder.hpp"
+#include "dot_stream.hpp"
+#include "dot_timing.hpp"
+
+class Dot;
+
+/// Runs the formatting and writing of published snapshots in the worker thread
+class DotWorker : public RTT::base::RunnableInterface {
+  public:
+    DotWorker(Dot* dot) : m_dot(dot) {}
+    bool initialize() { return true; }
+    void step();
+    void finalize() {}
+  private:
+    Dot* m_dot;
+};
 
 class Dot : public RTT::Service, public RTT::base::ExecutableInterface {
   public:
     // Constructor
     Dot(RTT::TaskContext* owner);
+    ~Dot();
     std::string getOwnerName();
 
     /** \brief Generate DOT file for the current deployment configuration
      *
      *  The method iterates over all peer components and generates and writes out a DOT file giving an overview of the current deployment configuration. The file currently displays all peer components, colored according to their taskstate, all component ports, names and connections to other components.
+     *  A fingerprint of the peers, their ports, connections and task states is kept, so that the file is only regenerated when one of them changed.
+     *  In async mode, only a snapshot of the deployment is taken here; formatting and writing happen in a low-priority worker thread.
+     *  The trigger_mode property decides whether an update looks at the deployment at all, see TriggerMode.
+     *  In record format, every generated snapshot is also appended to the recording right here, as a delta to the previous one where possible.
      */
     bool execute();
 
+    /** \brief Unconditionally generate the DOT file
+     *
+     *  Same as execute(), but regenerates the DOT file even if the deployment did not change since the last generation.
+     */
+    bool generate();
+
     /// @name Properties
     //@{
     /// Name of the DOT file to write the deployment configuration to
@@ -68,16 +111,410 @@ class Dot : public RTT::Service, public RTT::base::ExecutableInterface {
     std::string m_conn_args;
     /// Additional arguments to pass to the channel drawings
     std::string m_chan_args;
+    /// Comma separated list of the output formats to write: "dot", "json", "binary", "delta", "layout" and/or "record"
+    std::string m_formats;
+    /// Name of the JSON file to write the deployment configuration to
+    std::string m_json_file;
+    /// Name of the binary snapshot file to write the deployment configuration to
+    std::string m_binary_file;
+    /// Name of the file to append the changes between snapshots to
+    std::string m_delta_file;
+    /// Name of the memory-mapped file to record the snapshots in
+    std::string m_record_file;
+    /// Size in bytes of the recording, the oldest snapshots are overwritten once it is full
+    unsigned int m_record_size;
+    /// Name of the file to write the laid out graph to
+    std::string m_layout_file;
+    /// Graphviz command laying out the graph, called with "-o output input"
+    std::string m_layout_command;
+    /// Directory to cache the layouts in, empty for DotLayoutCache::defaultCacheDir()
+    std::string m_layout_cache_dir;
+    /// Format and write the DOT file in a worker thread instead of in execute()
+    bool m_async;
+    /// Priority of the worker thread
+    int m_worker_priority;
+    /// CPU affinity mask of the worker thread
+    unsigned int m_worker_cpu_affinity;
+    /// Path of the Unix domain socket to stream binary snapshots on, empty to not stream
+    std::string m_stream_socket;
+    /// Number of newer snapshots after which a subscriber still receiving an older one is disconnected
+    unsigned int m_stream_max_lag;
+    /// When execute() generates the DOT file: "update", "periodic", "on_demand" or "event"
+    std::string m_trigger_mode;
+    /// Minimal time in seconds between two generations in periodic mode
+    double m_min_period;
+    /// Time in seconds the deployment has to stay unchanged before it is generated in event mode
+    double m_debounce;
+    /// Also draw the peers of peers, to include sub-deployers and composite components
+    bool m_recursive;
+    /// Number of threads helping to scan the peers, 0 to scan them in execute() only
+    unsigned int m_scan_threads;
+    /// Priority of the scan threads, a positive one selects the real-time scheduler
+    int m_scan_priority;
+    /// CPU affinity mask of the scan threads
+    unsigned int m_scan_cpu_affinity;
+    /// Regular expressions on the peer names to draw and not to draw, empty to not filter
+    std::string m_component_include;
+    std::string m_component_exclude;
+    /// Regular expressions on the port names to draw and not to draw, empty to not filter
+    std::string m_port_include;
+    std::string m_port_exclude;
+    /// How components are grouped into clusters: "none", "prefix" or "activity"
+    std::string m_cluster_by;
+    /// Characters ending the name prefix components are clustered by in prefix mode
+    std::string m_cluster_separators;
+    /// Draw every cluster as a single node with aggregated connections
+    bool m_collapse_clusters;
+    /// Minimal number of local subscribers of an output drawn as a single hub node, 0 to never bundle them
+    unsigned int m_bundle_fanout;
+    /// Annotate the components with their activity and the measured cost of their steps, colored by load
+    bool m_timing;
+    /// Sample the fill level and dropped samples of the connection buffers and draw them on the edges
+    bool m_channel_stats;
+    /// Draw the operations the components call on each other through their OperationCallers
+    bool m_operations;
+    /// Length in seconds of the window the step costs and drop rates are measured over
+    double m_timing_window;
+    //@}
+
+    /// @name Statistics
+    //@{
+    /// Number of execute() calls that were skipped because the deployment did not change
+    unsigned int m_skip_count;
+    /// Number of times the DOT file was regenerated
+    unsigned int m_generate_count;
+    /// Number of snapshots dropped in async mode because the worker did not keep up
+    unsigned int m_coalesce_count;
     //@}
   private:
-    // Component name , with portname + shortcut (i0, o0 etc)
-    std::map<std::string,std::map<std::string,std::string> > comp_ports_map;
-    std::stringstream m_dot;
-    std::string mpeer;
-    std::string quote(std::string const& name);
-    void scanService(std::string path, RTT::Service::shared_ptr sv);
-    void buildComponentInputPortsMap(std::string path, RTT::Service::shared_ptr sv, int& current_count);
-    void buildComponentOutputPortsMap(std::string path, RTT::Service::shared_ptr sv, int& current_count);
-    std::string appendToPath(const std::string& path,const std::string& sub);
+    friend class DotWorker;
+
+    enum Format { DotFormat, JsonFormat, BinaryFormat, DeltaFormat, LayoutFormat, RecordFormat, NumFormats };
+
+    /// Snapshot handed from execute() to the worker thread
+    struct Snapshot
+    {
+        DotGraph graph;
+        DotOptions options;
+        /// Output file per Format, empty if the format is not selected
+        std::string files[NumFormats];
+        std::string stream_socket;
+        unsigned int stream_max_lag;
+        std::string layout_command;
+        std::string layout_cache_dir;
+        /// Settings of the stream thread, the ones of the worker
+        int worker_priority;
+        unsigned int worker_cpu_affinity;
+    };
+
+    /// Entry of the flat port table filled by scan()
+    struct PortEntry
+    {
+        RTT::base::PortInterface* port;
+        /// String id of the path of the providing sub-service, an index in PeerScan::paths while scanning a single peer
+        unsigned int path;
+        DotGraph::Direction direction;
+        /// Position among the peer's ports of the same direction
+        unsigned int field;
+        /// Index of the owning peer in m_peers
+        unsigned int peer;
+    };
+
+    struct PeerEntry
+    {
+        /// String id of the peer name
+        unsigned int name;
+        int state;
+        /// Index of the peer's first port in m_ports
+        unsigned int first_port;
+        /// String id of the cluster the peer is drawn in, DotGraph::empty if none
+        unsigned int cluster;
+        /// Only filled in timing mode
+        DotGraph::Timing timing;
+    };
+
+    /// Connection as found at the port m_ports[port], or PeerScan::ports[port] while scanning a single peer
+    struct ChannelEntry
+    {
+        unsigned int port;
+        RTT::base::PortInterface* writer;
+        RTT::base::PortInterface* reader;
+        RTT::ConnPolicy policy;
+        /// Buffer of the connection, 0 if it has none or it was not sampled
+        const void* buffer;
+        DotGraph::ChannelStats stats;
+    };
+
+    /// Operation called by a peer, found by scanCalls()
+    struct CallEntry
+    {
+        /// Index of the calling peer in m_peers
+        unsigned int peer;
+        RTT::TaskContext* callee;
+        /// Indices in PeerScan::call_names while scanning a single peer, string ids afterwards
+        unsigned int service;
+        unsigned int operation;
+        bool own_thread;
+        bool remote;
+        /// Several peers provide the operation, callee is the first one
+        bool guessed;
+    };
+
+    template<class T>
+    struct PointerHash
+    {
+        size_t operator()(const T* p) const { return reinterpret_cast<size_t>(p); }
+    };
+    typedef DotFlatMap<const RTT::base::PortInterface*, PointerHash<RTT::base::PortInterface> > PortIndex;
+    typedef DotFlatMap<const RTT::TaskContext*, PointerHash<RTT::TaskContext> > PeerIndex;
+
+    /// Verdict of the port filter on a port, with the name it was given for
+    struct PortVerdict
+    {
+        std::string name;
+        bool accepted;
+    };
+
+    /** Ports and connections of a single peer
+     *
+     *  Peers are scanned independently of each other, possibly in the threads of m_pool, without touching any shared state; scan() merges them in peer order afterwards.
+     */
+    struct PeerScan
+    {
+        RTT::TaskContext* tc;
+        /// String id of the peer name
+        unsigned int name;
+        int state;
+        /// Fingerprint of the services, ports and connections of the peer
+        uint64_t structure;
+        /// Paths of the scanned sub-services, only the first num_paths are used
+        std::vector<std::string> paths;
+        unsigned int num_paths;
+        std::vector<PortEntry> ports;
+        std::vector<ChannelEntry> channels;
+        /// Ports left out by port_filter, with their connections
+        std::vector<RTT::base::PortInterface*> excluded;
+        /// Filter on the port names, 0 to scan all ports
+        const DotFilter* port_filter;
+        /** Verdicts of port_filter, by port, index in port_verdicts
+         *  A steady-state scan only compares the port names to the cached ones. They are cleared when the filter generation or the peer changes.
+         */
+        PortIndex port_verdict_index;
+        std::vector<PortVerdict> port_verdicts;
+        unsigned int port_filter_generation;
+        /// Sample the buffers of the connections
+        bool channel_stats;
+        /// Find the operations the peer calls
+        bool operations;
+        std::vector<CallEntry> calls;
+        /// Names of the calls, only the first num_call_names are used
+        std::vector<std::string> call_names;
+        unsigned int num_call_names;
+        std::vector<std::string> peer_names;
+        /// Path of the service being scanned
+        std::string path;
+    };
+
+    struct IdHash
+    {
+        size_t operator()(unsigned int id) const { return id; }
+    };
+    typedef DotFlatMap<unsigned int, IdHash> NameIndex;
+
+    /// Scans the peers in the threads of m_pool
+    class ScanJob : public DotPool::Job {
+      public:
+        ScanJob(Dot* dot) : m_dot(dot) {}
+        void run(unsigned int index);
+      private:
+        Dot* m_dot;
+    };
+
+    // Tables filled by scan(), reused across calls
+    std::vector<PeerScan> m_scans;
+    unsigned int m_num_scans;
+    PeerIndex m_visited;
+    NameIndex m_names;
+    std::vector<unsigned int> m_path_ids;
+    std::vector<PeerEntry> m_peers;
+    std::vector<PortEntry> m_ports;
+    std::vector<ChannelEntry> m_channels;
+    std::vector<CallEntry> m_calls;
+    /// Index in m_peers of every scanned peer
+    PeerIndex m_peer_index;
+    PortIndex m_port_index;
+    DotPool m_pool;
+    ScanJob m_scan_job;
+    // Fingerprint computed by scan()
+    uint64_t m_structure;
+    uint64_t m_state;
+    PeerScan& addPeer(RTT::TaskContext* tc, unsigned int name);
+    void findPeers();
+    // Peers and ports left out by the filters, connections to them are not drawn
+    DotFilter m_component_filter;
+    DotFilter m_port_filter;
+    PeerIndex m_excluded_peers;
+    PortIndex m_excluded_ports;
+    /// Verdict of m_component_filter per peer name, cleared when the filter changes
+    NameIndex m_component_verdicts;
+    bool acceptPeer(RTT::TaskContext* tc, unsigned int name);
+
+    enum ClusterMode
+    {
+        /// Draw every component on its own
+        NoClusters,
+        /// Cluster components by their name up to the first of m_cluster_separators
+        PrefixClusters,
+        /// Cluster components run by the same thread
+        ActivityClusters
+    };
+    ClusterMode m_cluster_mode;
+    std::string m_parsed_cluster_by;
+    std::string m_cluster_name;
+    ClusterMode clusterMode();
+    unsigned int cluster(const PeerScan& scan);
+
+    // Step samplers run in the engines of the peers, found by their TaskContext
+    typedef DotFlatMap<const RTT::os::ThreadInterface*, PointerHash<RTT::os::ThreadInterface> > ThreadIndex;
+    struct SamplerEntry
+    {
+        RTT::TaskContext* tc;
+        std::unique_ptr<DotStepSampler> sampler;
+        /// Measured by the current scan
+        bool seen;
+    };
+    std::vector<SamplerEntry> m_samplers;
+    PeerIndex m_sampler_index;
+    /// Samplers of peers that left, deleted once their engine unloaded them
+    std::vector<std::unique_ptr<DotStepSampler> > m_retired_samplers;
+    /// Number of peers per thread
+    ThreadIndex m_thread_users;
+    std::vector<RTT::os::ThreadInterface*> m_peer_threads;
+    /// String ids of the kinds of activities, see activityKind()
+    unsigned int m_activity_kinds[6];
+    unsigned int activityKind(RTT::base::ActivityInterface* activity) const;
+    DotStepSampler* sampler(RTT::TaskContext* tc);
+    void sampleTimings();
+    /// Retire the samplers of the peers not measured by the current scan, or all of them; never waits for the engines
+    void retireSamplers(bool all);
+    static void scanPeer(PeerScan& scan);
+    /// Verdict of scan.port_filter on port, cached per port
+    static bool acceptPort(PeerScan& scan, RTT::base::PortInterface* port);
+    static void scanService(PeerScan& scan, RTT::Service::shared_ptr sv, unsigned int& inputs, unsigned int& outputs);
+    static void scanCalls(PeerScan& scan, RTT::ServiceRequester::shared_ptr sr, bool root);
+    static RTT::OperationInterfacePart* findOperation(RTT::TaskContext* peer, const std::string& service, const std::string& operation, bool root);
+    static bool findCallee(PeerScan& scan, const std::string& service, const std::string& operation, bool root, CallEntry& call);
+    static unsigned int callName(PeerScan& scan, const std::string& name);
+    static void sampleBuffer(ChannelEntry& ch, RTT::base::ChannelElementBase::shared_ptr element, bool at_input_port);
+
+    /// Dropped samples of a buffer at the start of the current window
+    struct DropWindow
+    {
+        const void* buffer;
+        unsigned int dropped;
+        RTT::os::TimeService::ticks start;
+        double rate;
+        /// Last scan that sampled the buffer
+        unsigned int generation;
+    };
+    typedef DotFlatMap<const void*, PointerHash<void> > BufferIndex;
+    std::vector<DropWindow> m_drop_windows;
+    BufferIndex m_drop_index;
+    unsigned int m_drop_generation;
+    /// Buffers sampled by the current scan
+    unsigned int m_drop_sampled;
+    double dropRate(const void* buffer, unsigned int dropped);
+    /// Forget the buffers of closed connections, once they outnumber the ones still sampled
+    void sweepDropWindows();
+    bool scan();
+    void buildGraph(DotGraph& graph);
+    /// String ids of the owner names drawn for endpoint ports without an interface
+    unsigned int m_free_input;
+    unsigned int m_free_output;
+    /// Index of port in the port table, or the name of a plain node in comp; false if the port was filtered out
+    bool resolve(RTT::base::PortInterface* port, unsigned int& index, unsigned int& comp, unsigned int free_name);
+
+    // Fingerprint of the deployment at the last successful generation
+    bool m_has_fingerprint;
+    uint64_t m_structure_hash;
+    uint64_t m_state_hash;
+    /// Whether the deployment differs from the last snapshot written; a snapshot the worker failed to write counts as a change
+    bool changed();
+    bool update(bool force);
+    bool debounce();
+    bool publish();
+
+    enum TriggerMode
+    {
+        /// Generate in every update in which the deployment changed
+        EveryUpdate,
+        /// Like EveryUpdate, but at most once every min_period seconds
+        Periodic,
+        /// Only generate through generate()
+        OnDemand,
+        /// Generate once the deployment stopped changing for debounce seconds
+        Event
+    };
+    TriggerMode m_mode;
+    std::string m_parsed_trigger_mode;
+    TriggerMode triggerMode();
+    RTT::os::TimeService::ticks m_last_update;
+    // A change seen in event mode that is not generated yet
+    bool m_pending;
+    RTT::os::TimeService::ticks m_pending_since;
+    RTT::os::TimeService::ticks m_last_change;
+    uint64_t m_pending_structure;
+    uint64_t m_pending_state;
+
+    /// The deployment model, rebuilt in place; its string table is the one all snapshots copy from
+    Snapshot m_current;
+
+    // Formats and writes a snapshot, either from execute() or from the worker thread
+    DotEmitter m_dot_emitter;
+    DotJsonEmitter m_json_emitter;
+    DotBinaryEmitter m_binary_emitter;
+    DotBackend* m_backends[NumFormats];
+    DotWriter m_out;
+    DotStream m_stream;
+    DotLayoutCache m_layout;
+    /// The layout format is selected in sync mode, which was warned about
+    bool m_layout_rejected;
+    bool writeSnapshot(const Snapshot& snapshot);
+
+    // Log of deltas, starting with the first snapshot written to it
+    DotGraph m_previous;
+    DotDelta m_delta;
+    std::string m_delta_path;
+    int m_delta_fd;
+    bool m_has_previous;
+    bool writeDelta(const Snapshot& snapshot);
+    void closeDelta();
+
+    /** Recording of the snapshots, appended to in execute() whatever the async mode
+     *  A full snapshot is recorded whenever a quarter of the ring was filled with deltas since the last one, so the oldest deltas left in the ring can be replayed.
+     */
+    DotRecorder m_recorder;
+    DotBinaryEmitter m_record_emitter;
+    DotWriter m_record_out;
+    DotGraph m_recorded;
+    DotDelta m_record_delta;
+    bool m_has_recorded;
+    bool record();
+
+    // Formats selected by m_formats
+    bool m_selected[NumFormats];
+    std::string m_parsed_formats;
+    void parseFormats();
+
+    DotHandoff<Snapshot> m_handoff;
+    DotWorker m_runner;
+    std::unique_ptr<RTT::Activity> m_worker;
+    int m_applied_priority;
+    unsigned int m_applied_cpu_affinity;
+    /// Set by the worker when it failed to write a snapshot, so that execute() writes the next one
+    std::atomic<bool> m_write_failed;
+    bool startWorker();
+    void stopWorker();
+    void flush();
 };
 #endif
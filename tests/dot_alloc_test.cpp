@@ -0,0 +1,194 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Checks that formatting a snapshot does not allocate once the buffers have grown
+ * @Author: OROCOS dot service contributors
+ *
+ * Renders a fixed deployment snapshot twice through every backend, with every drawing option,
+ * and fails if the second pass allocates any memory.
+ */
+
+#include "../src/dot_binary.hpp"
+#include "../src/dot_emitter.hpp"
+#include "../src/dot_json.hpp"
+#include <rtt/base/TaskCore.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using namespace RTT;
+
+// Count the heap allocations made while counting is set
+static bool counting = false;
+static unsigned long allocations = 0;
+
+void* operator new(size_t size)
+{
+    if(counting)
+        allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if(p == 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+/// Two clusters of sensors broadcasting to consumers, with a free input port, timings, buffer states and calls
+void buildGraph(DotGraph& graph)
+{
+    unsigned int sensors = graph.intern("sensors");
+    unsigned int control = graph.intern("control");
+    unsigned int sub = graph.intern("sub");
+    std::vector<unsigned int> outputs, inputs;
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "sensor_%u", i);
+        graph.addComponent(graph.intern(name), i == 2 ? base::TaskCore::Exception : base::TaskCore::Running, sensors);
+        outputs.push_back(graph.addPort(DotGraph::empty, graph.intern("out"), DotGraph::Output, 0));
+        outputs.push_back(graph.addPort(sub, graph.intern("raw"), DotGraph::Output, 1));
+    }
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "consumer_%u", i);
+        graph.addComponent(graph.intern(name), base::TaskCore::Stopped, control);
+        inputs.push_back(graph.addPort(DotGraph::empty, graph.intern("in"), DotGraph::Input, 0));
+        graph.addPort(DotGraph::empty, graph.intern("cmd"), DotGraph::Output, 0);
+    }
+
+    DotGraph::Channel ch = DotGraph::Channel();
+    ch.writer_comp = ch.reader_comp = DotGraph::npos;
+    ch.name_id = DotGraph::empty;
+    ch.at_input_port = true;
+    for(unsigned int i = 0; i < outputs.size(); i++)
+    {
+        ch.writer = outputs[i];
+        ch.type = i % 3;
+        ch.size = ch.type == 0 ? 0 : 16;
+        for(unsigned int j = 0; j < inputs.size(); j++)
+        {
+            ch.reader = inputs[j];
+            unsigned int k = graph.addChannel(ch);
+            DotGraph::ChannelStats stats = { 16, (i + j) % 17, j == 1 ? 5u : 0u, j == 1 ? 2.5 : 0.0 };
+            graph.setChannelStats(k, stats);
+        }
+    }
+    // A reader outside of the deployment
+    ch.writer = outputs[0];
+    ch.reader = DotGraph::npos;
+    ch.reader_comp = graph.intern("free input ports");
+    graph.addChannel(ch);
+
+    DotGraph::Timing timing = { graph.intern("Activity"), 0.01, true, 80, 3, 2, 100, 120.5, 800.25, 0.42 };
+    for(unsigned int i = 0; i < graph.components().size(); i += 2)
+    {
+        graph.setTiming(i, timing);
+    }
+
+    DotGraph::Call call = { 4, 0, DotGraph::npos, graph.intern("calibration"), graph.intern("calibrate"), true, false, false };
+    graph.addCall(call);
+    call.own_thread = false;
+    call.operation = graph.intern("getStatus");
+    graph.addCall(call);
+    call.guessed = true;
+    graph.addCall(call);
+    call.guessed = false;
+    call.callee = DotGraph::npos;
+    call.callee_name = graph.intern("planner");
+    call.remote = true;
+    graph.addCall(call);
+}
+
+bool check(const char* name, DotBackend& backend, const DotGraph& graph, const DotOptions& options)
+{
+    DotWriter out;
+    for(unsigned int pass = 0; pass < 2; pass++)
+    {
+        out.clear();
+        allocations = 0;
+        counting = pass == 1;
+        backend.render(graph, options, out);
+        counting = false;
+    }
+    printf("%-8s %6u bytes, %lu allocations\n", name, (unsigned int)out.size(), allocations);
+    return allocations == 0;
+}
+
+}
+
+int main()
+{
+    DotGraph graph;
+    buildGraph(graph);
+
+    DotEmitter dot;
+    DotJsonEmitter json;
+    DotBinaryEmitter binary;
+    DotOptions plain;
+    DotOptions all;
+    all.conn_args = "fontsize=9,";
+    all.bundle_fanout = 2;
+    all.timing = true;
+    all.channel_stats = true;
+    DotOptions collapsed = all;
+    collapsed.collapse_clusters = true;
+    DotOptions placeholders = plain;
+    placeholders.color_placeholders = true;
+
+    bool ok = true;
+    ok = check("dot", dot, graph, plain) && ok;
+    ok = check("dot", dot, graph, all) && ok;
+    ok = check("dot", dot, graph, collapsed) && ok;
+    ok = check("dot", dot, graph, placeholders) && ok;
+    ok = check("json", json, graph, all) && ok;
+    ok = check("binary", binary, graph, all) && ok;
+    if(!ok)
+    {
+        fprintf(stderr, "Rendering a snapshot a second time allocated memory\n");
+        return 1;
+    }
+    return 0;
+}
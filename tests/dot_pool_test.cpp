@@ -0,0 +1,119 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Checks that DotPool::run() only returns once every index ran exactly once
+ * @Author: OROCOS dot service contributors
+ *
+ * Resizes the pool between runs, so that threads join a pool that already ran jobs,
+ * and fails if an index did not run, or ran twice, by the time run() returned.
+ */
+
+#include "../src/dot_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace RTT;
+
+namespace {
+const unsigned int num_indices = 64;
+
+class CountJob : public DotPool::Job {
+  public:
+    CountJob() : m_counts(num_indices) {}
+
+    void run(unsigned int index)
+    {
+        // Slow indices keep the workers busy while the calling thread is done with its part
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        m_counts[index]++;
+    }
+
+    void reset()
+    {
+        for(unsigned int i = 0; i < m_counts.size(); i++)
+            m_counts[i].store(0);
+    }
+
+    bool check(unsigned int threads, unsigned int round)
+    {
+        bool ok = true;
+        for(unsigned int i = 0; i < m_counts.size(); i++)
+        {
+            int count = m_counts[i].load();
+            if(count != 1)
+            {
+                fprintf(stderr, "%u threads, round %u: index %u ran %d times\n", threads, round, i, count);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+  private:
+    std::vector<std::atomic<int> > m_counts;
+};
+}
+
+int main()
+{
+    const unsigned int sizes[] = { 1, 3, 2, 4, 0, 4, 1, 3 };
+    DotPool pool;
+    CountJob job;
+    bool ok = true;
+    for(unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        if(!pool.resize(sizes[s], ORO_SCHED_OTHER, 0, ~0u))
+        {
+            fprintf(stderr, "Unable to start %u threads\n", sizes[s]);
+            return 1;
+        }
+        // New threads step once when they start, let them do so before the next run
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for(unsigned int round = 0; round < 3; round++)
+        {
+            job.reset();
+            pool.run(job, num_indices);
+            ok = job.check(sizes[s], round) && ok;
+        }
+    }
+    if(!ok)
+    {
+        fprintf(stderr, "DotPool::run() returned before every index ran exactly once\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+/******************************************************************************
+*                           OROCOS dot service                                *
+*                                                                             *
+*                   (C) 2026 OROCOS dot service contributors                  *
+*                                                                             *
+*       You may redistribute this software and/or modify it under either the  *
+*       terms of the GNU Lesser General Public License version 2.1 (LGPLv2.1  *
+*       <http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html>) or (at your *
+*       discretion) of the Modified BSD License:                              *
+*       Redistribution and use in source and binary forms, with or without    *
+*       modification, are permitted provided that the following conditions    *
+*       are met:                                                              *
+*       1. Redistributions of source code must retain the above copyright     *
+*       notice, this list of conditions and the following disclaimer.         *
+*       2. Redistributions in binary form must reproduce the above copyright  *
+*       notice, this list of conditions and the following disclaimer in the   *
+*       documentation and/or other materials provided with the distribution.  *
+*       3. The name of the author may not be used to endorse or promote       *
+*       products derived from this software without specific prior written    *
+*       permission.                                                           *
+*       THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR  *
+*       IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED        *
+*       WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE    *
+*       ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,*
+*       INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES    *
+*       (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS       *
+*       OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) *
+*       HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,   *
+*       STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING *
+*       IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE    *
+*       POSSIBILITY OF SUCH DAMAGE.                                           *
+*                                                                             *
+*******************************************************************************/
+/* @Description:
+ * @brief Regenerates the deployment at any moment of a recording of the OROCOS dot service
+ * @Author: OROCOS dot service contributors
+ *
+ * Replays the snapshots and deltas of a recording made in the 'record' format up to the given time,
+ * and writes the deployment as it was then in DOT or JSON.
+ *
+ * Usage: rtt_dot_replay [--list] [--time seconds] [--format dot|json] [--output file] recording
+ * Without --time, the deployment at the end of the recording is written; without --output, it is written to stdout.
+ * --list prints every recorded frame with its time, as seconds of the RTT TimeService, and the task state changes it holds.
+ */
+
+#include "../src/dot_binary.hpp"
+#include "../src/dot_delta.hpp"
+#include "../src/dot_emitter.hpp"
+#include "../src/dot_json.hpp"
+#include "../src/dot_recorder.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool readFile(const char* path, std::vector<char>& data)
+{
+    FILE* f = fopen(path, "rb");
+    if(f == 0)
+    {
+        return false;
+    }
+    char buffer[65536];
+    size_t n;
+    while((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+void usage()
+{
+    fprintf(stderr, "Usage: rtt_dot_replay [--list] [--time seconds] [--format dot|json] [--output file] recording\n");
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    bool list = false;
+    bool until = false;
+    uint64_t time = 0;
+    std::string format = "dot";
+    std::string output;
+    const char* path = 0;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--list")
+            list = true;
+        else if(arg == "--time" && i + 1 < argc)
+        {
+            until = true;
+            time = uint64_t(strtod(argv[++i], 0) * 1e9 + 0.5);
+        }
+        else if(arg == "--format" && i + 1 < argc)
+            format = argv[++i];
+        else if(arg == "--output" && i + 1 < argc)
+            output = argv[++i];
+        else if(path == 0 && arg.compare(0, 2, "--") != 0)
+            path = argv[i];
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            usage();
+            return 1;
+        }
+    }
+    if(path == 0 || (format != "dot" && format != "json"))
+    {
+        usage();
+        return 1;
+    }
+
+    std::vector<char> data;
+    std::vector<DotRecorder::Frame> frames;
+    if(!readFile(path, data))
+    {
+        fprintf(stderr, "Unable to read %s\n", path);
+        return 1;
+    }
+    if(!DotRecorder::read(data.data(), data.size(), frames))
+    {
+        fprintf(stderr, "%s is not a valid recording\n", path);
+        return 1;
+    }
+
+    // Deltas recorded before the oldest snapshot left in the ring cannot be replayed
+    DotGraph graph;
+    DotDelta delta;
+    bool replayed = false;
+    for(size_t i = 0; i < frames.size(); i++)
+    {
+        const DotRecorder::Frame& frame = frames[i];
+        if(until && frame.timestamp > time)
+        {
+            break;
+        }
+        bool snapshot = frame.type == DotBinaryFrame::SnapshotFrame;
+        if(snapshot)
+        {
+            replayed = DotBinaryEmitter::read(frame.data, frame.size, graph);
+        }
+        else if(replayed)
+        {
+            replayed = delta.read(frame.data, frame.size, graph) && delta.apply(graph);
+        }
+        if(!list)
+        {
+            continue;
+        }
+        printf("%llu.%09llu %s %u bytes", (unsigned long long)(frame.timestamp / 1000000000), (unsigned long long)(frame.timestamp % 1000000000),
+               snapshot ? "snapshot" : "delta", frame.size);
+        if(!replayed)
+        {
+            printf(", not replayable\n");
+            continue;
+        }
+        if(snapshot)
+        {
+            printf(", %u components\n", (unsigned int)graph.components().size());
+            continue;
+        }
+        printf(", %u changes\n", (unsigned int)delta.records().size());
+        const std::vector<DotDelta::Record>& records = delta.records();
+        for(size_t j = 0; j < records.size(); j++)
+        {
+            const DotDelta::Record& rec = records[j];
+            if(rec.op == DotDelta::SetState || rec.op == DotDelta::AddComponent)
+            {
+                const DotGraph::Component& comp = graph.components()[rec.index];
+                printf("    %s%s %s\n", rec.op == DotDelta::AddComponent ? "new " : "", graph.str(comp.name).c_str(), DotBackend::stateName(comp.state));
+            }
+        }
+    }
+    if(list)
+    {
+        return 0;
+    }
+    if(!replayed)
+    {
+        fprintf(stderr, "No snapshot recorded at that time\n");
+        return 1;
+    }
+
+    DotEmitter dot_emitter;
+    DotJsonEmitter json_emitter;
+    DotBackend& backend = format == "json" ? static_cast<DotBackend&>(json_emitter) : dot_emitter;
+    DotOptions options;
+    DotWriter out;
+    backend.render(graph, options, out);
+    if(output.empty())
+    {
+        return fwrite(out.data(), 1, out.size(), stdout) == out.size() ? 0 : 1;
+    }
+    if(!out.writeFile(output))
+    {
+        fprintf(stderr, "Unable to write %s\n", output.c_str());
+        return 1;
+    }
+    return 0;
+}